@@ -1,4 +1,4 @@
-QT       += core gui webenginewidgets sql
+QT       += core gui webenginewidgets sql concurrent
 
 CONFIG += c++17
 
@@ -13,6 +13,19 @@ SOURCES += \
     main.cpp \
     mainwindow.cpp \
     webbridge.cpp \
+    db/student_sql.cpp \
+    db/bulk_importer.cpp \
+    db/db_executor.cpp \
+    db/db_reader_pool.cpp \
+    db/schema.cpp \
+    db/student_search.cpp \
+    db/storage_profile.cpp \
+    db/statement_cache.cpp \
+    io/json_stream_reader.cpp \
+    io/json_stream_writer.cpp \
+    io/student_snapshot.cpp \
+    io/student_json_convert.cpp \
+    io/student_json_cache.cpp \
     im/user.cpp \
     im/room.cpp \
     im/im_go_bridge/im_bridge.cpp
@@ -20,8 +33,35 @@ SOURCES += \
 HEADERS += \
     mainwindow.h \
     webbridge.h \
+    db/student_sql.h \
+    db/bulk_importer.h \
+    db/db_executor.h \
+    db/db_reader_pool.h \
+    db/schema.h \
+    db/student_search.h \
+    db/storage_profile.h \
+    db/statement_cache.h \
+    io/json_stream_reader.h \
+    io/json_stream_writer.h \
+    io/student_snapshot.h \
+    io/student_json_convert.h \
+    io/student_json_cache.h \
     struct/student.h \
     struct/stu_with_score.h \
+    struct/course_names.h \
+    struct/string_pool.h \
+    struct/json_scan.h \
+    struct/json_writer.h \
+    struct/student_json_reader.h \
+    struct/symbol.h \
+    struct/student_store.h \
+    struct/student_query.h \
+    struct/change_log.h \
+    struct/startup_timeline.h \
+    struct/score_analytics.h \
+    struct/student_rank.h \
+    struct/student_table.h \
+    struct/student_diff.h \
     struct/other_users.h \
     struct/course.h \
     im/user.h \
@@ -32,6 +72,12 @@ HEADERS += \
 RESOURCES += \
     resources.qrc
 
+# 导出 .json.gz 需要 zlib
+unix {
+    LIBS += -lz
+    DEFINES += HAVE_ZLIB
+}
+
 DESTDIR = $$PWD/bin
 OBJECTS_DIR = $$PWD/build/obj
 MOC_DIR = $$PWD/build/moc
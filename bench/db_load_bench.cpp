@@ -0,0 +1,197 @@
+// 冷启动加载基准：同一批学生分别存成旧的 JSON 列结构和规范化结构，
+// 各自用新连接完整加载一次并计时，同时记录原地升级本身的耗时，
+// 再和从二进制快照加载比较，最后在升级建好的全文索引上跑几条典型搜索。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target db_load_bench
+// 运行: db_load_bench [学生数 ...]，默认 10000 100000
+
+#include "db/schema.h"
+#include "db/statement_cache.h"
+#include "db/student_search.h"
+#include "db/student_sql.h"
+#include "io/student_snapshot.h"
+
+#include <QCoreApplication>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QtSql/QSqlError>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    const QString kConnection = "db_load_bench";
+
+    auto make_student(long id) -> Stu_withScore {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({2003, 1 + static_cast<int>(id % 12), 1 + static_cast<int>(id % 28)});
+        s.set_enroll_year(2020 + static_cast<int>(id % 5));
+        s.set_major("计算机科学与技术");
+        s.set_class(static_cast<int>(id % 30));
+        s.set_contact({"1380000" + std::to_string(id % 10000), "stu" + std::to_string(id) + "@example.com"});
+        s.set_address({"江苏省", "南京市"});
+        s.add_family_member({"父亲" + std::to_string(id), "父子", {"1390000", "f@example.com"}});
+        s.add_family_member({"母亲" + std::to_string(id), "母子", {"1370000", "m@example.com"}});
+        return s;
+    }
+
+    // 版本 0 的结构和写入方式
+    void fill_legacy(QSqlDatabase& db, long n) {
+        QSqlQuery query(db);
+        query.exec("CREATE TABLE students (student_id INTEGER PRIMARY KEY, name TEXT NOT NULL, sex TEXT, "
+                   "birthdate TEXT, age INTEGER, enroll_year INTEGER, major TEXT, class_id INTEGER, "
+                   "contact_info TEXT, address TEXT, family_members TEXT, status TEXT, password TEXT)");
+        db.transaction();
+        query.prepare("INSERT INTO students VALUES (:id, :name, :sex, :birthdate, :age, :enroll_year, :major, "
+                      ":class_id, :contact_info, :address, :family_members, :status, 'password')");
+        for (long i = 0; i < n; ++i) {
+            Stu_withScore s = make_student(2024000000 + i);
+            query.bindValue(":id", QVariant::fromValue(s.get_id()));
+            query.bindValue(":name", QString::fromStdString(s.get_name()));
+            query.bindValue(":sex", s.get_sex() == Sex::Male ? "男" : "女");
+            query.bindValue(":birthdate", QDate(s.get_birthdate().year, s.get_birthdate().month, s.get_birthdate().day));
+            query.bindValue(":age", s.get_age());
+            query.bindValue(":enroll_year", s.get_enroll_year());
+            query.bindValue(":major", QString::fromStdString(s.get_major()));
+            query.bindValue(":class_id", s.get_class());
+            query.bindValue(":contact_info", QJsonDocument(contact_to_qjson(s.get_contact())).toJson(QJsonDocument::Compact));
+            query.bindValue(":address", QJsonDocument(address_to_qjson(s.get_address())).toJson(QJsonDocument::Compact));
+            QJsonArray family;
+            for (const auto& fm : s.get_family_members()) family.append(family_member_to_qjson(fm));
+            query.bindValue(":family_members", QJsonDocument(family).toJson(QJsonDocument::Compact));
+            query.bindValue(":status", status_to_qjson_string(s.get_status()));
+            query.exec();
+        }
+        db.commit();
+    }
+
+    // 版本 0 的加载方式：SELECT * 后每行三次 JSON 解析
+    void load_legacy(QSqlDatabase& db, std::vector<Stu_withScore>& out) {
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        query.exec("SELECT * FROM students");
+        while (query.next()) {
+            Stu_withScore student;
+            student.set_id(query.value("student_id").toLongLong());
+            student.set_name(query.value("name").toString().toStdString());
+            student.set_sex(query.value("sex").toString() == "男" ? Sex::Male : Sex::Female);
+            QDate date = query.value("birthdate").toDate();
+            student.set_birthdate({date.year(), date.month(), date.day()});
+            student.set_enroll_year(query.value("enroll_year").toInt());
+            student.set_major(query.value("major").toString().toStdString());
+            student.set_class(query.value("class_id").toInt());
+            student.set_contact(contact_from_qjson(QJsonDocument::fromJson(query.value("contact_info").toString().toUtf8()).object()));
+            student.set_address(address_from_qjson(QJsonDocument::fromJson(query.value("address").toString().toUtf8()).object()));
+            std::vector<FamilyMember> familyMembers;
+            for (const auto& fm : QJsonDocument::fromJson(query.value("family_members").toString().toUtf8()).array()) {
+                familyMembers.push_back(family_member_from_qjson(fm.toObject()));
+            }
+            student.set_family_members(familyMembers);
+            student.set_status(status_from_qjson_string(query.value("status").toString()));
+            out.push_back(std::move(student));
+        }
+    }
+
+    // 每次计时都用新连接，模拟应用冷启动
+    template<typename F>
+    auto timed_on_fresh_connection(const QString& path, F&& f) -> double {
+        double ms = 0;
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kConnection);
+            db.setDatabaseName(path);
+            db.open();
+            QElapsedTimer timer;
+            timer.start();
+            f(db);
+            ms = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+            StatementCache::release(kConnection);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(kConnection);
+        return ms;
+    }
+
+    void run(long n) {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("bench.sqlite");
+
+        timed_on_fresh_connection(path, [&] (QSqlDatabase& db) { fill_legacy(db, n); });
+
+        std::vector<Stu_withScore> legacy;
+        legacy.reserve(static_cast<std::size_t>(n));
+        double legacyMs = timed_on_fresh_connection(path, [&] (QSqlDatabase& db) { load_legacy(db, legacy); });
+
+        bool migrated   = false;
+        double migrateMs = timed_on_fresh_connection(path, [&] (QSqlDatabase& db) {
+            migrated = migrate_schema(db)["success"].toBool();
+        });
+
+        std::vector<Stu_withScore> normalized;
+        normalized.reserve(static_cast<std::size_t>(n));
+        double normalizedMs = timed_on_fresh_connection(path, [&] (QSqlDatabase& db) {
+            select_all_students(db, normalized);
+        });
+
+        std::size_t family = 0;
+        for (const auto& s : normalized) family += s.get_family_members().size();
+
+        std::printf("%8ld students | legacy load %9.1f ms | migrate %9.1f ms (%s) | normalized load %9.1f ms | %.2fx\n",
+                    n, legacyMs, migrateMs, migrated ? "ok" : "FAILED", normalizedMs,
+                    normalizedMs > 0 ? legacyMs / normalizedMs : 0.0);
+        std::printf("         loaded %zu / %zu students, %zu family members\n",
+                    legacy.size(), normalized.size(), family);
+
+        // 快照：应用退出时写出，下次启动时只读一行数据版本再映射文件
+        QJsonObject revision;
+        timed_on_fresh_connection(path, [&] (QSqlDatabase& db) { revision = read_data_revision(db); });
+        StudentStore store;
+        store.reserve(normalized.size());
+        for (const auto& s : normalized) store.upsert(s);
+        const QString snapshotPath = dir.filePath("students.snapshot");
+        const QString dbId         = revision["dbId"].toString();
+        const qint64 rev           = revision["revision"].toInteger();
+        QElapsedTimer timer;
+        timer.start();
+        const QJsonObject written = write_student_snapshot(snapshotPath, store, dbId, rev);
+        const double writeMs      = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+        std::vector<Stu_withScore> fromSnapshot;
+        QJsonObject read;
+        double snapshotMs = timed_on_fresh_connection(path, [&] (QSqlDatabase& db) {
+            const QJsonObject current = read_data_revision(db);
+            read = read_student_snapshot(snapshotPath, current["dbId"].toString(), current["revision"].toInteger(),
+                                         fromSnapshot);
+        });
+        std::printf("         snapshot write %9.1f ms (%lld bytes) | snapshot load %9.1f ms (%s, %zu students) | %.2fx\n",
+                    writeMs, static_cast<long long>(written["bytes"].toInteger()), snapshotMs,
+                    read["success"].toBool() ? "ok" : read["message"].toString().toUtf8().constData(),
+                    fromSnapshot.size(), snapshotMs > 0 ? normalizedMs / snapshotMs : 0.0);
+
+        for (const QString& q : {QString("stu%1").arg(2024000000 + n / 2), QString("计算机"), QString("南京 stu2024")}) {
+            qsizetype hits = 0;
+            double searchMs = timed_on_fresh_connection(path, [&] (QSqlDatabase& db) {
+                hits = search_students(db, q, 20)["results"].toArray().size();
+            });
+            std::printf("         search %-20s %6lld hits %9.2f ms\n", q.toUtf8().constData(),
+                        static_cast<long long>(hits), searchMs);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    std::vector<long> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::stol(argv[i]));
+    if (sizes.empty()) sizes = {10000, 100000};
+
+    for (long n : sizes) run(n);
+    return 0;
+}
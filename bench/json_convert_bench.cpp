@@ -0,0 +1,85 @@
+// 导入转换基准：同一批学生 JSON 元素（每个学生 2 个家庭成员、4 门成绩）
+// 分别用 1、2、4、8 个线程的线程池交给 convert_student_elements，
+// 按导入时的批大小分批转换，报告耗时和相对单线程的加速比。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target json_convert_bench
+// 运行: json_convert_bench [学生数]，默认 200000
+
+#include "io/student_json_convert.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QThread>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr std::size_t kBatch = 4096; // 与导入时的 kImportConvertBatch 一致
+
+    auto make_student(long id) -> Stu_withScore {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({2003, 1 + static_cast<int>(id % 12), 1 + static_cast<int>(id % 28)});
+        s.set_enroll_year(2020 + static_cast<int>(id % 5));
+        s.set_major("计算机科学与技术");
+        s.set_class(static_cast<int>(id % 30));
+        s.set_contact({"1380000" + std::to_string(id % 10000), "stu" + std::to_string(id) + "@example.com"});
+        s.set_address({"江苏省", "南京市"});
+        s.add_family_member({"父亲" + std::to_string(id), "父子", {"1390000", "f@example.com"}});
+        s.add_family_member({"母亲" + std::to_string(id), "母子", {"1370000", "m@example.com"}});
+        for (const char* course : {"高等数学", "大学英语", "大学物理", "程序设计"}) {
+            s.add_score(course, Score(60.0 + static_cast<double>(id % 40), 3.0));
+        }
+        return s;
+    }
+
+    auto convert_all(const std::vector<JsonElement>& elements, QThreadPool* pool) -> std::size_t {
+        std::size_t converted = 0;
+        for (std::size_t first = 0; first < elements.size(); first += kBatch) {
+            const auto last = std::min(elements.size(), first + kBatch);
+            std::vector<JsonElement> batch(elements.begin() + static_cast<std::ptrdiff_t>(first),
+                                           elements.begin() + static_cast<std::ptrdiff_t>(last));
+            converted += convert_student_elements(batch, static_cast<qint64>(first), pool).students.size();
+        }
+        return converted;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const long n = argc > 1 ? std::stol(argv[1]) : 200000;
+
+    std::vector<JsonElement> elements;
+    elements.reserve(static_cast<std::size_t>(n));
+    qint64 offset = 0;
+    for (long i = 0; i < n; ++i) {
+        const QJsonDocument doc(stu_with_score_to_qjson(make_student(2024000000 + i)));
+        QByteArray bytes = doc.toJson(QJsonDocument::Compact);
+        offset += bytes.size();
+        elements.push_back({std::move(bytes), offset});
+    }
+    std::printf("%ld elements, %.1f MB, ideal thread count %d\n", n, static_cast<double>(offset) / (1024 * 1024),
+                QThread::idealThreadCount());
+
+    double baseline = 0;
+    for (int threads : {1, 2, 4, 8}) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(threads);
+        convert_all(elements, &pool); // 预热：课程名、专业等先进入字符串池
+
+        QElapsedTimer timer;
+        timer.start();
+        const std::size_t converted = convert_all(elements, &pool);
+        const double ms             = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+        if (threads == 1) baseline = ms;
+        std::printf("%2d threads | %9.1f ms | %7.0f records/s | %.2fx (%zu converted)\n", threads, ms,
+                    static_cast<double>(converted) * 1000.0 / ms, baseline / ms, converted);
+    }
+    return 0;
+}
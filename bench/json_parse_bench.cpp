@@ -0,0 +1,52 @@
+// 导入解析基准：同一批学生 JSON 元素（每个学生 2 个家庭成员、4 门成绩）
+//   qt     : QJsonDocument::fromJson + stu_with_score_from_qjson，即原来的导入路径；
+//   reader : StudentJsonReader::parse 直接解码。
+// 两条路径结果一致由 tests/student_json_reader_test.cpp 的差分测试保证，这里只计时。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target json_parse_bench
+// 运行: json_parse_bench [学生数]，默认 200000
+
+#include "struct/student_json_reader.h"
+#include "tests/student_json_samples.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    auto view_of(const QByteArray& bytes) -> std::string_view {
+        return {bytes.constData(), static_cast<std::size_t>(bytes.size())};
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    const long n = argc > 1 ? std::stol(argv[1]) : 200000;
+
+    std::vector<QByteArray> elements;
+    elements.reserve(static_cast<std::size_t>(n));
+    qint64 bytesTotal = 0;
+    for (long i = 0; i < n; ++i) {
+        elements.push_back(QJsonDocument(stu_with_score_to_qjson(make_sample_student(2024000000 + i))).toJson(QJsonDocument::Compact));
+        bytesTotal += elements.back().size();
+    }
+
+    long sink = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (const auto& bytes : elements) sink += stu_with_score_from_qjson(QJsonDocument::fromJson(bytes).object()).get_id() & 1;
+    const double qtMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+    timer.restart();
+    for (const auto& bytes : elements) sink += StudentJsonReader::parse(view_of(bytes))->get_id() & 1;
+    const double readerMs = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+
+    const double mb = static_cast<double>(bytesTotal) / (1024 * 1024);
+    std::printf("%ld elements, %.1f MB | qt %9.1f ms (%6.1f MB/s) | reader %9.1f ms (%6.1f MB/s) | %.1fx (checksum %ld)\n",
+                n, mb, qtMs, mb * 1000 / qtMs, readerMs, mb * 1000 / readerMs, qtMs / readerMs, sink);
+    return 0;
+}
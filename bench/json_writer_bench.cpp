@@ -0,0 +1,94 @@
+// 桥接响应序列化基准：同一批学生（每个学生 2 个家庭成员、4 门成绩）
+//   dom    : stu_with_score_to_qjson 逐个构造 QJsonObject 放进 QJsonArray，再 toJson(Compact)，
+//            即 query_students 返回对象、QWebChannel 再序列化的路径；
+//   writer : JsonWriter 直接写出 UTF-8，再 QString::fromUtf8，即 query_students_json 的路径。
+// 先检查两条路径解析后的内容一致，再分别计时。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target json_writer_bench
+// 运行: json_writer_bench [学生数 ...]，默认 50 1000 100000
+
+#include "struct/stu_with_score.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    auto make_student(long id) -> Stu_withScore {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({2003, 1 + static_cast<int>(id % 12), 1 + static_cast<int>(id % 28)});
+        s.set_enroll_year(2020 + static_cast<int>(id % 5));
+        s.set_major("计算机科学与技术");
+        s.set_class(static_cast<int>(id % 30));
+        s.set_contact({"1380000" + std::to_string(id % 10000), "stu" + std::to_string(id) + "@example.com"});
+        s.set_address({"江苏省", "南京市"});
+        s.add_family_member({"父亲" + std::to_string(id), "父子", {"1390000", "f@example.com"}});
+        s.add_family_member({"母亲" + std::to_string(id), "母子", {"1370000", "m@example.com"}});
+        for (const char* course : {"高等数学", "大学英语", "大学物理", "程序设计"}) {
+            s.add_score(course, Score(60.5 + static_cast<double>(id % 40), 3.0));
+        }
+        return s;
+    }
+
+    auto dom_json(const std::vector<Stu_withScore>& students) -> QByteArray {
+        QJsonArray arr;
+        for (const auto& s : students) arr.append(stu_with_score_to_qjson(s));
+        return QJsonDocument(arr).toJson(QJsonDocument::Compact);
+    }
+
+    auto writer_json(const std::vector<Stu_withScore>& students, JsonWriter& w) -> QString {
+        w.clear();
+        w.begin_array();
+        for (const auto& s : students) write_json(w, s);
+        w.end_array();
+        return QString::fromUtf8(w.data(), static_cast<qsizetype>(w.size()));
+    }
+
+    template<typename F>
+    auto best_ms(int reps, F&& f) -> double {
+        double best = 1e300;
+        for (int r = 0; r < reps; ++r) {
+            QElapsedTimer timer;
+            timer.start();
+            f();
+            best = std::min(best, static_cast<double>(timer.nsecsElapsed()) / 1e6);
+        }
+        return best;
+    }
+
+    qsizetype sink = 0;
+
+    void run(long n) {
+        std::vector<Stu_withScore> students;
+        students.reserve(static_cast<std::size_t>(n));
+        for (long i = 0; i < n; ++i) students.push_back(make_student(2024000000 + i));
+
+        JsonWriter w;
+        const QString text = writer_json(students, w);
+        const bool same    = QJsonDocument::fromJson(text.toUtf8()) == QJsonDocument::fromJson(dom_json(students));
+
+        const int reps        = n >= 100000 ? 3 : 20;
+        const double domMs    = best_ms(reps, [&] { sink += dom_json(students).size(); });
+        const double writerMs = best_ms(reps, [&] { sink += writer_json(students, w).size(); });
+        std::printf("%7ld students | %8.1f KB | dom %9.3f ms | writer %8.3f ms | %5.1fx | same content: %s\n", n,
+                    static_cast<double>(w.size()) / 1024, domMs, writerMs, domMs / writerMs, same ? "yes" : "NO");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    std::vector<long> sizes;
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::stol(argv[i]));
+    if (sizes.empty()) sizes = {50, 1000, 100000};
+    for (long n : sizes) run(n);
+    std::printf("(checksum %lld)\n", static_cast<long long>(sink));
+    return 0;
+}
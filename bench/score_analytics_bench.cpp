@@ -0,0 +1,107 @@
+// 成绩统计基准：100k / 1M 条成绩（每个学生 4 门课），
+// 列式统计与逐个学生遍历各自成绩的做法对比，另测增量更新的单次延迟。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target score_analytics_bench
+
+#include "struct/score_analytics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const char* const kCourses[] = {"math", "english", "physics", "chemistry"};
+
+    auto make_student(long id, std::mt19937_64& rng) -> Stu_withScore {
+        std::normal_distribution<double> score(72.0, 12.0);
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_major(id % 2 ? "CS" : "EE");
+        s.set_class(static_cast<int>(id % 30));
+        for (const char* course : kCourses) s.add_score(course, Score(std::clamp(score(rng), 0.0, 100.0), 0));
+        return s;
+    }
+
+    template<typename F>
+    auto ms(F&& f) -> double {
+        auto start = Clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double sink = 0;
+
+    // 对照组：直接遍历内存库，每门课收集成绩后排序求中位数
+    auto naive_stats(const StudentStore& store) -> double {
+        double acc = 0;
+        for (const char* course : kCourses) {
+            std::vector<double> values;
+            double sum = 0;
+            store.for_each([&] (const Stu_withScore& s) {
+                auto it = s.get_all_scores().find(course);
+                if (it == s.get_all_scores().end()) return;
+                values.push_back(it->second.score);
+                sum += it->second.score;
+            });
+            const double mean = sum / static_cast<double>(values.size());
+            double sq         = 0;
+            for (double v : values) sq += (v - mean) * (v - mean);
+            std::sort(values.begin(), values.end());
+            acc += mean + std::sqrt(sq / static_cast<double>(values.size())) + values[values.size() / 2];
+        }
+        return acc;
+    }
+
+    void run(std::size_t students) {
+        constexpr long base = 2024000000;
+        std::mt19937_64 rng(42);
+        StudentStore store;
+        store.reserve(students);
+        for (std::size_t i = 0; i < students; ++i) store.insert(make_student(base + static_cast<long>(i), rng));
+
+        ScoreColumns columns;
+        const double build_ms = ms([&] { columns.rebuild(store); });
+
+        ScoreStatsOptions all;
+        const double stats_ms = ms([&] {
+            for (const auto& s : columns.stats(all)) sink += s.mean + s.median;
+        });
+        ScoreStatsOptions one_class;
+        one_class.classId        = 7;
+        const double filtered_ms = ms([&] {
+            for (const auto& s : columns.stats(one_class)) sink += s.mean + s.median;
+        });
+        const double naive_ms = ms([&] { sink += naive_stats(store); });
+
+        constexpr std::size_t ops = 100000;
+        std::uniform_int_distribution<std::size_t> pick(0, students - 1);
+        const double update_ms = ms([&] {
+            for (std::size_t i = 0; i < ops; ++i) {
+                columns.upsert(make_student(base + static_cast<long>(pick(rng)), rng));
+            }
+        });
+        const double erase_ms = ms([&] {
+            for (std::size_t i = 0; i < ops; ++i) columns.erase(base + static_cast<long>(pick(rng)));
+        });
+
+        std::printf("%8zu scores | rebuild %8.1f ms | stats %7.1f ms | class filter %7.1f ms | student scan %8.1f ms"
+                    " || upsert %6.0f ns | erase %6.0f ns\n",
+                    students * std::size(kCourses), build_ms, stats_ms, filtered_ms, naive_ms,
+                    update_ms * 1e6 / ops, erase_ms * 1e6 / ops);
+    }
+}
+
+int main() {
+    for (std::size_t n : {25000u, 250000u}) {
+        run(n);
+    }
+    std::printf("(checksum %.1f)\n", sink);
+    return 0;
+}
@@ -0,0 +1,112 @@
+// 成绩存储基准：每个学生 40 门课，10k / 100k 名学生，
+// 按课程 id 排序的连续数组（CourseScores）与原先 std::map<std::string, Score> 对比：
+// 堆内存占用、构建、按课程名查分和求平均分的耗时。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target score_storage_bench
+
+#include "struct/stu_with_score.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// 统计堆上仍在使用的字节数。标准容器通过 std::allocator 释放时走带大小的 operator delete，
+// 足够统计这里的两种成绩存储
+namespace {
+    std::size_t liveBytes = 0;
+}
+
+void* operator new(std::size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    liveBytes += size;
+    return p;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t size) noexcept {
+    liveBytes -= size;
+    std::free(ptr);
+}
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kCourses = 40;
+
+    // 旧实现：每门课一个 map 节点加一个课程名字符串
+    struct LegacyScores {
+        std::map<std::string, Score> courseScore;
+
+        double get_score(const std::string& course) const {
+            auto it = courseScore.find(course);
+            return it != courseScore.end() ? it->second.score : 0.0;
+        }
+
+        double calculate_average() const {
+            if (courseScore.empty()) return 0.0;
+            double sum = 0.0;
+            for (const auto& pair : courseScore) sum += pair.second.score;
+            return sum / static_cast<double>(courseScore.size());
+        }
+    };
+
+    template<typename F>
+    auto ns_per_op(std::size_t ops, F&& f) -> double {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < ops; ++i) f(i);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        return static_cast<double>(ns) / static_cast<double>(ops);
+    }
+
+    double sink = 0;
+
+    template<typename Store, typename Add>
+    void run_one(const char* label, std::size_t n, const std::vector<std::string>& names, Add&& add) {
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<std::size_t> pickStudent(0, n - 1);
+        std::uniform_int_distribution<std::size_t> pickCourse(0, names.size() - 1);
+
+        std::vector<Store> students(n);
+        const std::size_t before = liveBytes; // 只算成绩本身，不算学生对象
+        const double add_ns = ns_per_op(n * names.size(), [&] (std::size_t i) {
+            add(students[i / names.size()], names[(i * 7) % names.size()], Score(static_cast<double>(i % 101), 3.0));
+        });
+        const double bytes = static_cast<double>(liveBytes - before) / static_cast<double>(n);
+
+        constexpr std::size_t ops = 1000000;
+        std::vector<std::pair<std::size_t, std::size_t>> probes(ops);
+        for (auto& p : probes) p = {pickStudent(rng), pickCourse(rng)};
+        const double get_ns = ns_per_op(ops, [&] (std::size_t i) {
+            sink += students[probes[i].first].get_score(names[probes[i].second]);
+        });
+        const double avg_ns = ns_per_op(ops, [&] (std::size_t i) {
+            sink += students[probes[i].first].calculate_average();
+        });
+
+        std::printf("%7zu | %-12s | heap %7.0f B/student | add %6.1f | get_score %6.1f | average %6.1f  (ns/op)\n",
+                    n, label, bytes, add_ns, get_ns, avg_ns);
+    }
+}
+
+int main() {
+    std::vector<std::string> names;
+    for (int i = 0; i < kCourses; ++i) names.push_back("专业核心课程" + std::to_string(i + 1));
+
+    for (std::size_t n : {10000u, 100000u}) {
+        run_one<LegacyScores>("std::map", n, names, [] (LegacyScores& s, const std::string& c, Score score) {
+            s.courseScore[c] = score;
+        });
+        run_one<Stu_withScore>("CourseScores", n, names, [] (Stu_withScore& s, const std::string& c, Score score) {
+            s.add_score(c, score);
+        });
+    }
+    std::printf("(checksum %.1f)\n", sink);
+    return 0;
+}
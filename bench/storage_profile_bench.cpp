@@ -0,0 +1,182 @@
+// 存储配置基准：先检查重复学号的导入和合并导入保留密码，再对每个 StorageProfile 用新数据库分别测
+//   - 导入：BulkImporter 单事务写入全部学生
+//   - 全量加载：新连接上 select_all_students
+//   - 单条更新：逐条 update_student，每条一个事务（synchronous 的差别主要体现在这里）
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target storage_profile_bench
+// 运行: storage_profile_bench [学生数 [更新次数]]，默认 50000 2000
+
+#include "db/bulk_importer.h"
+#include "db/schema.h"
+#include "db/statement_cache.h"
+#include "db/storage_profile.h"
+#include "db/student_sql.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    const QString kConnection = "storage_profile_bench";
+
+    auto make_student(long id) -> Stu_withScore {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({2003, 1 + static_cast<int>(id % 12), 1 + static_cast<int>(id % 28)});
+        s.set_enroll_year(2020 + static_cast<int>(id % 5));
+        s.set_major("计算机科学与技术");
+        s.set_class(static_cast<int>(id % 30));
+        s.set_contact({"1380000" + std::to_string(id % 10000), "stu" + std::to_string(id) + "@example.com"});
+        s.set_address({"江苏省", "南京市"});
+        s.add_family_member({"父亲" + std::to_string(id), "父子", {"1390000", "f@example.com"}});
+        s.add_score("高等数学", Score(60.0 + static_cast<double>(id % 40), 2.0));
+        s.add_score("大学英语", Score(70.0 + static_cast<double>(id % 30), 3.0));
+        return s;
+    }
+
+    // 每个阶段都用新连接并重新应用配置，和应用打开数据库的方式一致
+    template<typename F>
+    auto timed_with_profile(const QString& path, const StorageProfile& profile, F&& f) -> double {
+        double ms = 0;
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kConnection);
+            db.setDatabaseName(path);
+            db.open();
+            apply_storage_profile(db, profile);
+            QElapsedTimer timer;
+            timer.start();
+            f(db);
+            ms = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+            StatementCache::release(kConnection);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(kConnection);
+        return ms;
+    }
+
+    auto per_second(long count, double ms) -> double {
+        return ms > 0 ? static_cast<double>(count) * 1000.0 / ms : 0.0;
+    }
+
+    // 文件中同一学号出现两次时以后一次为准：家庭成员和成绩不能残留前一次的，
+    // 清空整表导入和合并导入都要成功
+    auto check_duplicate_import(bool replaceAll) -> bool {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("duplicate.sqlite");
+
+        Stu_withScore last = make_student(2024000000);
+        last.set_name("后一次");
+        last.set_family_members({});
+        last.add_family_member({"母亲", "母子", {"1370000", "m@example.com"}});
+        last.del_score("大学英语");
+
+        bool ok = false;
+        timed_with_profile(path, StorageProfile{}, [&] (QSqlDatabase& db) {
+            migrate_schema(db);
+            BulkImporter importer(db);
+            if (!importer.begin(replaceAll)) return;
+            for (const Stu_withScore& s : {make_student(2024000000), make_student(2024000001), last}) {
+                if (!importer.add(s)) return;
+            }
+            if (!importer.commit()) return;
+
+            std::vector<Stu_withScore> loaded;
+            select_all_students(db, loaded);
+            ok = loaded.size() == 2 && loaded[0].get_name() == "后一次"
+                 && loaded[0].get_family_members().size() == 1 && loaded[0].get_family_members()[0].name == "母亲"
+                 && loaded[0].get_all_scores().size() == 1;
+            if (!ok) std::printf("duplicate ids (%s): %s\n", replaceAll ? "replace" : "merge",
+                                 importer.last_error().toUtf8().constData());
+        });
+        return ok;
+    }
+
+    // 合并导入改写已有学生时不能把密码重置为占位值；新学号才写入占位密码
+    auto check_merge_keeps_password() -> bool {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("password.sqlite");
+
+        bool ok = false;
+        timed_with_profile(path, StorageProfile{}, [&] (QSqlDatabase& db) {
+            migrate_schema(db);
+            insert_student(db, make_student(2024000000));
+            QSqlQuery query(db);
+            query.exec("UPDATE students SET password = 'secret' WHERE student_id = 2024000000");
+
+            Stu_withScore changed = make_student(2024000000);
+            changed.set_name("改过");
+            BulkImporter importer(db);
+            if (!importer.begin(false) || !importer.add(changed) || !importer.add(make_student(2024000001))
+                || !importer.commit()) {
+                std::printf("merge password: %s\n", importer.last_error().toUtf8().constData());
+                return;
+            }
+            query.exec("SELECT name, password FROM students ORDER BY student_id");
+            ok = query.next() && query.value(0).toString() == "改过" && query.value(1).toString() == "secret"
+                 && query.next() && query.value(1).toString() == "password";
+            query.finish();
+        });
+        return ok;
+    }
+
+    void run(const StorageProfile& profile, long n, long updates) {
+        QTemporaryDir dir;
+        const QString path = dir.filePath("bench.sqlite");
+
+        timed_with_profile(path, profile, [] (QSqlDatabase& db) { migrate_schema(db); });
+
+        bool imported = false;
+        double importMs = timed_with_profile(path, profile, [&] (QSqlDatabase& db) {
+            BulkImporter importer(db);
+            importer.set_expected_total(static_cast<int>(n));
+            if (!importer.begin(true)) return;
+            for (long i = 0; i < n; ++i) {
+                if (!importer.add(make_student(2024000000 + i))) return;
+            }
+            imported = importer.commit();
+        });
+
+        std::vector<Stu_withScore> loaded;
+        loaded.reserve(static_cast<std::size_t>(n));
+        double loadMs = timed_with_profile(path, profile, [&] (QSqlDatabase& db) { select_all_students(db, loaded); });
+
+        long updated = 0;
+        double updateMs = timed_with_profile(path, profile, [&] (QSqlDatabase& db) {
+            for (long i = 0; i < updates && !loaded.empty(); ++i) {
+                Stu_withScore& s = loaded[static_cast<std::size_t>(i * 7919 % static_cast<long>(loaded.size()))];
+                s.add_score("高等数学", Score(static_cast<double>(i % 100), 1.0));
+                if (update_student(db, s)["success"].toBool()) ++updated;
+            }
+        });
+
+        std::printf("%-8s %8ld students | import %9.1f ms (%9.0f/s)%s | load %8.1f ms (%9.0f/s) | "
+                    "update %8.1f ms (%7.0f/s, %ld ok)\n",
+                    profile.name.toUtf8().constData(), n,
+                    importMs, per_second(n, importMs), imported ? "" : " FAILED",
+                    loadMs, per_second(static_cast<long>(loaded.size()), loadMs),
+                    updateMs, per_second(updated, updateMs), updated);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    const long n       = argc > 1 ? std::stol(argv[1]) : 50000;
+    const long updates = argc > 2 ? std::stol(argv[2]) : 2000;
+
+    const bool duplicatesOk = check_duplicate_import(true) && check_duplicate_import(false);
+    std::printf("duplicate ids: %s\n", duplicatesOk ? "ok" : "FAILED");
+    const bool passwordOk = check_merge_keeps_password();
+    std::printf("merge keeps password: %s\n", passwordOk ? "ok" : "FAILED");
+
+    for (const StorageProfile& profile : {StorageProfile{}, durable_storage_profile(), fast_storage_profile()}) {
+        run(profile, n, updates);
+    }
+    return duplicatesOk && passwordOk ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+// StudentStore 单次操作延迟基准：10k / 100k / 1M 条记录，
+// 与原先 std::vector + std::find_if 的线性查找对比。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target student_store_bench
+
+#include "struct/student_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    auto make_student(long id) -> Stu_withScore {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_major("CS");
+        s.set_class(static_cast<int>(id % 30));
+        s.set_enroll_year(2020 + static_cast<int>(id % 5));
+        return s;
+    }
+
+    template<typename F>
+    auto ns_per_op(std::size_t ops, F&& f) -> double {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < ops; ++i) f(i);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        return static_cast<double>(ns) / static_cast<double>(ops);
+    }
+
+    long sink = 0;
+
+    void run(std::size_t n) {
+        constexpr long base = 2024000000;
+        std::mt19937_64 rng(42);
+        std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+
+        std::vector<long> probes(100000);
+        for (auto& p : probes) p = base + static_cast<long>(pick(rng));
+
+        StudentStore store;
+        store.reserve(n);
+        double insert_ns = ns_per_op(n, [&] (std::size_t i) {
+            store.insert(make_student(base + static_cast<long>(i)));
+        });
+
+        double find_ns = ns_per_op(probes.size(), [&] (std::size_t i) {
+            sink += store.find(probes[i])->get_class();
+        });
+
+        double update_ns = ns_per_op(probes.size(), [&] (std::size_t i) {
+            Stu_withScore* s = store.find(probes[i]);
+            s->set_class(s->get_class() + 1);
+            store.update(*s);
+        });
+
+        // 删除一半探针后再插回，覆盖墓碑与槽位复用路径
+        std::size_t churn = std::min<std::size_t>(probes.size(), n / 2);
+        double erase_ns = ns_per_op(churn, [&] (std::size_t i) {
+            sink += store.erase(probes[i]);
+        });
+        double reinsert_ns = ns_per_op(churn, [&] (std::size_t i) {
+            store.upsert(make_student(probes[i]));
+        });
+
+        // 对照组：旧实现的线性扫描
+        std::vector<Stu_withScore> linear;
+        linear.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) linear.push_back(make_student(base + static_cast<long>(i)));
+        std::size_t linear_ops = std::max<std::size_t>(10, 2000000 / n);
+        double linear_find_ns = ns_per_op(linear_ops, [&] (std::size_t i) {
+            long id = probes[i];
+            auto it = std::find_if(linear.begin(), linear.end(),
+                                   [id] (const Stu_withScore& s) { return s.get_id() == id; });
+            sink += it->get_class();
+        });
+        double linear_erase_ns = ns_per_op(linear_ops, [&] (std::size_t i) {
+            long id = probes[i];
+            auto it = std::remove_if(linear.begin(), linear.end(),
+                                     [id] (const Stu_withScore& s) { return s.get_id() == id; });
+            linear.erase(it, linear.end());
+        });
+
+        std::printf("%8zu | insert %8.1f | find %8.1f | update %8.1f | erase %8.1f | reinsert %8.1f"
+                    " || vector find %12.1f | vector erase %12.1f  (ns/op)\n",
+                    n, insert_ns, find_ns, update_ns, erase_ns, reinsert_ns,
+                    linear_find_ns, linear_erase_ns);
+    }
+}
+
+int main() {
+    for (std::size_t n : {10000u, 100000u, 1000000u}) {
+        run(n);
+    }
+    std::printf("(checksum %ld)\n", sink);
+    return 0;
+}
@@ -0,0 +1,115 @@
+// 列存过滤基准：100k / 1M 个学生，
+// StudentTable 的位图谓词与逐个学生调用 StudentFilter::matches 的遍历对比，
+// 分别测只求位图、求出学生指针两种结果，以及增量维护的单次延迟。
+//
+// 构建: cmake -DBUILD_BENCHMARKS=ON ... && cmake --build . --target student_table_bench
+
+#include "struct/student_table.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const char* const kMajors[] = {"CS", "EE", "Math", "Physics", "Chemistry", "Biology", "History", "Law"};
+
+    auto make_student(long id, std::mt19937_64& rng) -> Stu_withScore {
+        std::uniform_int_distribution<int> year(2018, 2025), cls(1, 30), status(0, 2), major(0, 7), day(1, 28);
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("stu" + std::to_string(id));
+        s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({year(rng) - 19, 1 + day(rng) % 12, day(rng)});
+        s.set_enroll_year(year(rng));
+        s.set_class(cls(rng));
+        s.set_status(static_cast<Status>(status(rng)));
+        s.set_major(kMajors[major(rng)]);
+        return s;
+    }
+
+    template<typename F>
+    auto ms(F&& f) -> double {
+        auto start = Clock::now();
+        f();
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::size_t sink = 0;
+
+    void run(std::size_t students) {
+        constexpr long base = 2024000000;
+        constexpr int reps  = 20;
+        std::mt19937_64 rng(42);
+        StudentStore store;
+        store.reserve(students);
+        for (std::size_t i = 0; i < students; ++i) store.insert(make_student(base + static_cast<long>(i), rng));
+
+        StudentTable table;
+        const double build_ms = ms([&] { table.rebuild(store); });
+
+        // status == Active && enrollYear == 2024 && class == 3
+        StudentFilter filter;
+        filter.status        = Status::Active;
+        filter.enrollYearMin = 2024;
+        filter.enrollYearMax = 2024;
+        filter.classId       = 3;
+
+        const double scan_ms = ms([&] {
+            for (int r = 0; r < reps; ++r) {
+                std::vector<const Stu_withScore*> matched;
+                store.for_each([&] (const Stu_withScore& s) {
+                    if (filter.matches(s)) matched.push_back(&s);
+                });
+                sink += matched.size();
+            }
+        }) / reps;
+        const double bitmap_ms = ms([&] {
+            for (int r = 0; r < reps; ++r) sink += table.select(filter).count();
+        }) / reps;
+        const double rows_ms = ms([&] {
+            for (int r = 0; r < reps; ++r) sink += table.matching(filter, store).size();
+        }) / reps;
+
+        StudentFilter by_major;
+        by_major.major                = Symbol("CS");
+        const double major_scan_ms = ms([&] {
+            for (int r = 0; r < reps; ++r) {
+                std::size_t n = 0;
+                store.for_each([&] (const Stu_withScore& s) { n += by_major.matches(s); });
+                sink += n;
+            }
+        }) / reps;
+        const double major_bitmap_ms = ms([&] {
+            for (int r = 0; r < reps; ++r) sink += table.select(by_major).count();
+        }) / reps;
+
+        constexpr std::size_t ops = 100000;
+        std::uniform_int_distribution<std::size_t> pick(0, students - 1);
+        const double update_ms = ms([&] {
+            for (std::size_t i = 0; i < ops; ++i) {
+                const long id = base + static_cast<long>(pick(rng));
+                table.upsert(*store.find(id), store.handle_of(id));
+            }
+        });
+        const double erase_ms = ms([&] {
+            for (std::size_t i = 0; i < ops; ++i) table.erase(base + static_cast<long>(pick(rng)));
+        });
+
+        std::printf("%8zu students | rebuild %7.1f ms | 3-column filter: scan %7.2f ms, bitmap %6.2f ms, rows %6.2f ms"
+                    " | major: scan %7.2f ms, bitmap %6.2f ms || upsert %5.0f ns | erase %5.0f ns\n",
+                    students, build_ms, scan_ms, bitmap_ms, rows_ms, major_scan_ms, major_bitmap_ms,
+                    update_ms * 1e6 / ops, erase_ms * 1e6 / ops);
+    }
+}
+
+int main() {
+    for (std::size_t n : {100000u, 1000000u}) {
+        run(n);
+    }
+    std::printf("(checksum %zu)\n", sink);
+    return 0;
+}
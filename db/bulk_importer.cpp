@@ -0,0 +1,144 @@
+#include "db/bulk_importer.h"
+#include "db/schema.h"
+#include "db/student_search.h"
+#include "db/student_sql.h"
+
+#include <QVariant>
+#include <QtSql/QSqlError>
+
+BulkImporter::BulkImporter(const QSqlDatabase& db, QObject* parent)
+    : QObject(parent), m_db(db) {}
+
+BulkImporter::~BulkImporter() {
+    // 未提交就销毁视为失败
+    if (m_active) rollback();
+}
+
+void BulkImporter::set_chunk_size(int chunkSize) {
+    m_chunkSize = chunkSize > 0 ? chunkSize : 1;
+}
+
+bool BulkImporter::begin(bool replaceAll) {
+    m_count   = 0;
+    m_removed = 0;
+    m_lastError.clear();
+
+    if (!m_db.isOpen()) {
+        return fail("数据库未连接", m_db.lastError().text());
+    }
+    if (!m_db.transaction()) {
+        return fail("开启事务失败", m_db.lastError().text());
+    }
+    m_active     = true;
+    m_replaceAll = replaceAll;
+
+    if (replaceAll) {
+        QSqlQuery clear(m_db);
+        if (!clear.exec("DELETE FROM students_fts") || !clear.exec("DELETE FROM grades")
+            || !clear.exec("DELETE FROM family_members")
+            || !clear.exec("DELETE FROM students")) {
+            return fail("清空 'students' 表失败", clear.lastError().text());
+        }
+    }
+
+    // 语句留在连接的缓存里，下次导入不用重新 prepare
+    StatementCache& cache = StatementCache::of(m_db);
+    m_insert        = cache.get(kUpsertStudentSql);
+    m_insertFamily  = cache.get(kInsertFamilyMemberSql);
+    m_deleteFamily  = cache.get(kDeleteFamilyMembersSql);
+    m_deleteGrades  = cache.get(kDeleteGradesSql);
+    m_unindex       = replaceAll ? nullptr : cache.get(kUnindexStudentSql);
+    m_deleteStudent = replaceAll ? nullptr : cache.get(kDeleteStudentSql);
+    m_findCourse    = cache.get(kSelectCourseIdSql);
+    m_insertCourse  = cache.get(kInsertCourseSql);
+    m_upsertGrade   = cache.get(kUpsertGradeSql);
+    m_index         = cache.get(kIndexStudentSql);
+    if (!m_insert || !m_insertFamily || !m_deleteFamily || !m_deleteGrades || !m_findCourse || !m_insertCourse
+        || !m_upsertGrade || !m_index || (!replaceAll && (!m_unindex || !m_deleteStudent))) {
+        return fail("预编译语句失败", cache.last_error());
+    }
+    return true;
+}
+
+bool BulkImporter::add(const Stu_withScore& student) {
+    if (!m_active) return false;
+
+    bind_student_columns(m_insert->query, student);
+    m_insert->query.bindValue(":password", "password"); // Placeholder for password，只用于新学号
+    if (!m_insert->exec()) {
+        return fail(QString("写入学生 %1 失败").arg(student.get_id()), m_insert->query.lastError().text());
+    }
+    // 导入的学生整体替换原有记录，成绩也以文件为准。清空整表时也要删：
+    // 文件里同一学号出现多次时，前一次写入的家庭成员和成绩还在
+    for (StatementCache::Statement* del : {m_deleteFamily, m_deleteGrades}) {
+        del->query.bindValue(":id", QVariant::fromValue(student.get_id()));
+        if (!del->exec()) {
+            return fail(QString("写入学生 %1 失败").arg(student.get_id()), del->query.lastError().text());
+        }
+    }
+    if (!insert_family_members(*m_insertFamily, student)) {
+        return fail(QString("写入学生 %1 的家庭成员失败").arg(student.get_id()),
+                    m_insertFamily->query.lastError().text());
+    }
+    QString error;
+    if (!upsert_scores(*m_findCourse, *m_insertCourse, *m_upsertGrade, student, error)) {
+        return fail(QString("写入学生 %1 的成绩失败").arg(student.get_id()), error);
+    }
+    if (!index_student(*m_index, student)) {
+        return fail(QString("写入学生 %1 的搜索索引失败").arg(student.get_id()), m_index->query.lastError().text());
+    }
+
+    if (++m_count % m_chunkSize == 0) {
+        emit progress(m_count, m_total);
+    }
+    return true;
+}
+
+bool BulkImporter::remove(long studentId) {
+    if (!m_active || m_replaceAll) return false;
+
+    for (StatementCache::Statement* del : {m_unindex, m_deleteGrades, m_deleteFamily, m_deleteStudent}) {
+        del->query.bindValue(":id", QVariant::fromValue(studentId));
+        if (!del->exec()) {
+            return fail(QString("删除学生 %1 失败").arg(studentId), del->query.lastError().text());
+        }
+    }
+    ++m_removed;
+    return true;
+}
+
+bool BulkImporter::commit() {
+    if (!m_active) return false;
+    finish_statements();
+    QString error;
+    if (!bump_data_revision(m_db, error)) {
+        return fail("提交事务失败", error);
+    }
+    if (!m_db.commit()) {
+        return fail("提交事务失败", m_db.lastError().text());
+    }
+    m_active = false;
+    emit progress(m_count, m_total);
+    return true;
+}
+
+void BulkImporter::rollback() {
+    if (!m_active) return;
+    finish_statements();
+    m_db.rollback();
+    m_active = false;
+}
+
+void BulkImporter::finish_statements() {
+    for (StatementCache::Statement* statement :
+         {m_insert, m_insertFamily, m_deleteFamily, m_deleteGrades, m_unindex, m_deleteStudent, m_findCourse,
+          m_insertCourse, m_upsertGrade, m_index}) {
+        if (statement) statement->query.finish();
+    }
+}
+
+bool BulkImporter::fail(const QString& what, const QString& error) {
+    m_lastError = error.isEmpty() ? what : what + ": " + error;
+    rollback();
+    return false;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "db/statement_cache.h"
+#include "struct/stu_with_score.h"
+
+#include <QObject>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+
+// 批量导入：整个导入包在一个事务里，复用连接缓存中预编译的语句，
+// 每写满 chunkSize 条发出一次进度。任何一条失败都会回滚整个事务，
+// 表不会停留在被清空一半的状态。
+//
+// 用法: begin() -> add() / remove() ... -> commit()；失败时调用 rollback()。
+class BulkImporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit BulkImporter(const QSqlDatabase& db, QObject* parent = nullptr);
+    ~BulkImporter() override;
+
+    void set_chunk_size(int chunkSize);
+    auto chunk_size() const -> int { return m_chunkSize; }
+
+    // 预计总条数，仅用于进度信号；未知时保持 -1
+    void set_expected_total(int total) { m_total = total; }
+
+    // replaceAll 为 true 时在同一事务内先清空学生、家庭成员、成绩和搜索索引
+    bool begin(bool replaceAll);
+    bool add(const Stu_withScore& student);
+    // 删除学生及其家庭成员、成绩和索引行；只能在 begin(false) 之后使用
+    bool remove(long studentId);
+    bool commit();
+    void rollback();
+
+    auto imported_count() const -> int { return m_count; }
+    auto removed_count() const -> int { return m_removed; }
+    auto last_error() const -> QString { return m_lastError; }
+
+signals:
+    // 每写完一个分块以及提交成功时发出
+    void progress(int imported, int total);
+
+private:
+    bool fail(const QString& what, const QString& error);
+    void finish_statements();
+
+    // 归连接的 StatementCache 所有，begin() 时取出
+    QSqlDatabase m_db;
+    StatementCache::Statement* m_insert{nullptr};
+    StatementCache::Statement* m_insertFamily{nullptr};
+    StatementCache::Statement* m_deleteFamily{nullptr};
+    StatementCache::Statement* m_deleteGrades{nullptr};
+    StatementCache::Statement* m_unindex{nullptr};       // 只在不清空整表时需要，remove() 用
+    StatementCache::Statement* m_deleteStudent{nullptr}; // 同上
+    StatementCache::Statement* m_findCourse{nullptr};
+    StatementCache::Statement* m_insertCourse{nullptr};
+    StatementCache::Statement* m_upsertGrade{nullptr};
+    StatementCache::Statement* m_index{nullptr};
+    int m_chunkSize{1000};
+    int m_count{0};
+    int m_removed{0};
+    int m_total{-1};
+    bool m_active{false};
+    bool m_replaceAll{false};
+    QString m_lastError;
+};
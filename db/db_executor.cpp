@@ -0,0 +1,137 @@
+#include "db/db_executor.h"
+#include "db/statement_cache.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QtSql/QSqlError>
+
+#include <exception>
+#include <future>
+#include <memory>
+
+DbExecutor::DbExecutor(const QString& databasePath, const QString& connectionName,
+                       const StorageProfile& profile, QObject* parent)
+    : QObject(parent), m_worker(new QObject), m_databasePath(databasePath), m_connectionName(connectionName),
+      m_profile(profile) {
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.setObjectName("DbExecutor " + connectionName);
+    m_thread.start();
+}
+
+// 任务抛出的异常不能穿过事件循环，统一转换成失败结果
+auto DbExecutor::run_task(const Task& task, QSqlDatabase& db) -> QJsonObject {
+    QJsonObject result;
+    try {
+        result = task(db);
+    } catch (const std::exception& e) {
+        result["success"] = false;
+        result["message"] = QString("数据库请求失败: %1").arg(e.what());
+    } catch (...) {
+        result["success"] = false;
+        result["message"] = "数据库请求失败 (未知错误)";
+    }
+    return result;
+}
+
+DbExecutor::~DbExecutor() {
+    shutdown();
+}
+
+qint64 DbExecutor::submit(Task task, Callback callback) {
+    QMutexLocker locker(&m_mutex);
+    if (m_stopped) return 0;
+
+    const qint64 id = m_nextId++;
+    ++m_inFlight;
+    m_queue.push_back({id, std::move(task), std::move(callback)});
+    if (!m_draining) {
+        m_draining = true;
+        QMetaObject::invokeMethod(m_worker, [this] { drain(); }, Qt::QueuedConnection);
+    }
+    return id;
+}
+
+QJsonObject DbExecutor::run_blocking(Task task) {
+    Q_ASSERT(QThread::currentThread() != &m_thread);
+
+    auto promise = std::make_shared<std::promise<QJsonObject>>();
+    std::future<QJsonObject> future = promise->get_future();
+    const qint64 id = submit([task = std::move(task), promise] (QSqlDatabase& db) {
+        QJsonObject result = run_task(task, db);
+        promise->set_value(result);
+        return result;
+    });
+    if (id == 0) {
+        QJsonObject result;
+        result["success"] = false;
+        result["message"] = "数据库线程已停止";
+        return result;
+    }
+    return future.get();
+}
+
+auto DbExecutor::pending_count() const -> int {
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_queue.size());
+}
+
+void DbExecutor::shutdown() {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_stopped) return;
+        m_stopped = true;
+    }
+    // 排在所有已提交请求之后执行，保证写入不会丢失
+    QMetaObject::invokeMethod(m_worker, [this] {
+        drain();
+        close_connection();
+        m_thread.quit();
+    }, Qt::QueuedConnection);
+    m_thread.wait();
+}
+
+void DbExecutor::drain() {
+    if (!m_db.isValid()) open_connection();
+
+    for (;;) {
+        Request request;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (m_queue.empty()) {
+                m_draining = false;
+                return;
+            }
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+
+        QJsonObject result = run_task(request.task, m_db);
+        --m_inFlight;
+        QMetaObject::invokeMethod(this, [this, id = request.id, callback = std::move(request.callback), result] {
+            if (callback) callback(result);
+            emit request_finished(id, result);
+        }, Qt::QueuedConnection);
+    }
+}
+
+void DbExecutor::open_connection() {
+    m_db = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    m_db.setDatabaseName(m_databasePath);
+    if (!m_db.open()) {
+        qWarning() << "[DbExecutor] 打开数据库失败:" << m_db.lastError().text();
+        return;
+    }
+    const QJsonObject applied = apply_storage_profile(m_db, m_profile);
+    if (!applied["success"].toBool()) {
+        qWarning() << "[DbExecutor] 应用存储配置" << m_profile.name << "失败:" << applied["message"].toString();
+    }
+}
+
+void DbExecutor::close_connection() {
+    if (!m_db.isValid()) return;
+    StatementCache::release(m_connectionName);
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "db/storage_profile.h"
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QtSql/QSqlDatabase>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+
+// 数据库执行器：在独立的 QThread 上持有自己的 QSqlDatabase 连接，
+// 按提交顺序逐个执行请求，GUI 线程不再直接执行任何 SQL。
+//
+// 请求以 Task 的形式提交，在工作线程上拿到连接执行；返回的 QJsonObject
+// 通过 request_finished 信号（以及可选的回调）送回 DbExecutor 所在的线程。
+class DbExecutor : public QObject {
+    Q_OBJECT
+
+public:
+    using Task     = std::function<QJsonObject(QSqlDatabase&)>;
+    using Callback = std::function<void(const QJsonObject&)>;
+
+    // 连接在工作线程上首次执行请求时打开，并立即应用 profile
+    DbExecutor(const QString& databasePath, const QString& connectionName,
+               const StorageProfile& profile = {}, QObject* parent = nullptr);
+    ~DbExecutor() override;
+
+    // 线程安全，立即返回请求 id；callback 在 DbExecutor 所在线程上调用
+    qint64 submit(Task task, Callback callback = {});
+
+    // 排队执行并阻塞等待结果，只给必须同步返回的旧接口使用，
+    // 不能在工作线程上调用
+    QJsonObject run_blocking(Task task);
+
+    auto connection_name() const -> const QString& { return m_connectionName; }
+
+    // 队列中尚未执行的请求数
+    auto pending_count() const -> int;
+    // 已提交但还没执行完的请求数，包括正在执行的那个
+    auto in_flight_count() const -> int { return m_inFlight; }
+
+    // 多个执行器共用 request_finished 时用不同的起点避免请求 id 重复，
+    // 必须在第一次 submit 之前调用
+    void set_first_request_id(qint64 id) { m_nextId = id; }
+
+    // 执行 task，把抛出的异常转换成失败结果
+    static auto run_task(const Task& task, QSqlDatabase& db) -> QJsonObject;
+
+    // 停止接收新请求，执行完已排队的请求后关闭连接并结束线程
+    void shutdown();
+
+signals:
+    void request_finished(qint64 requestId, const QJsonObject& result);
+
+private:
+    struct Request {
+        qint64 id{};
+        Task task;
+        Callback callback;
+    };
+
+    void drain();           // 工作线程
+    void open_connection(); // 工作线程
+    void close_connection();
+
+    QThread m_thread;
+    QObject* m_worker;      // 生活在工作线程上的上下文对象
+    QString m_databasePath;
+    QString m_connectionName;
+    StorageProfile m_profile;
+    QSqlDatabase m_db;      // 只在工作线程上访问
+
+    mutable QMutex m_mutex;
+    std::deque<Request> m_queue;
+    bool m_draining{false};
+    bool m_stopped{false};
+    std::atomic<qint64> m_nextId{1};
+    std::atomic<int> m_inFlight{0};
+};
@@ -0,0 +1,51 @@
+#include "db/db_reader_pool.h"
+
+#include <QThread>
+
+#include <algorithm>
+
+namespace {
+    // 每个执行器的请求 id 各占一段，和写执行器（从 1 开始）也不会重复
+    constexpr qint64 kRequestIdStride = qint64(1) << 40;
+}
+
+DbReaderPool::DbReaderPool(const QString& databasePath, const QString& connectionPrefix, const StorageProfile& profile,
+                           int readers, QObject* parent)
+    : QObject(parent) {
+    if (readers <= 0) readers = std::clamp(QThread::idealThreadCount(), 2, 4);
+
+    const StorageProfile readerProfile = reader_storage_profile(profile);
+    for (int i = 0; i < readers; ++i) {
+        auto* reader = new DbExecutor(databasePath, QString("%1-reader-%2").arg(connectionPrefix).arg(i),
+                                      readerProfile, this);
+        reader->set_first_request_id(kRequestIdStride * (i + 1));
+        connect(reader, &DbExecutor::request_finished, this, &DbReaderPool::request_finished);
+        m_readers.push_back(reader);
+    }
+}
+
+DbReaderPool::~DbReaderPool() {
+    shutdown();
+}
+
+auto DbReaderPool::least_busy() -> DbExecutor* {
+    DbExecutor* best = nullptr;
+    for (std::size_t n = 0; n < m_readers.size(); ++n) {
+        DbExecutor* reader = m_readers[(m_next + n) % m_readers.size()];
+        if (!best || reader->in_flight_count() < best->in_flight_count()) best = reader;
+    }
+    m_next = (m_next + 1) % m_readers.size();
+    return best;
+}
+
+qint64 DbReaderPool::submit(Task task, Callback callback) {
+    return least_busy()->submit(std::move(task), std::move(callback));
+}
+
+QJsonObject DbReaderPool::run_blocking(Task task) {
+    return least_busy()->run_blocking(std::move(task));
+}
+
+void DbReaderPool::shutdown() {
+    for (DbExecutor* reader : m_readers) reader->shutdown();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "db/db_executor.h"
+
+#include <QObject>
+#include <QString>
+
+#include <vector>
+
+// 只读连接池：若干个 DbExecutor，每个有自己的线程和命名连接
+// （<prefix>-reader-<n>，query_only）。写入仍然只走唯一的写执行器。
+//
+// 配合 WAL，读请求可以和写请求以及彼此之间并行执行；
+// 代价是读不保证看到写执行器里还在排队的写入。
+class DbReaderPool : public QObject {
+    Q_OBJECT
+
+public:
+    using Task     = DbExecutor::Task;
+    using Callback = DbExecutor::Callback;
+
+    // readers <= 0 时按 CPU 核数取 2~4 个
+    DbReaderPool(const QString& databasePath, const QString& connectionPrefix, const StorageProfile& profile,
+                 int readers = 0, QObject* parent = nullptr);
+    ~DbReaderPool() override;
+
+    // 交给当前最空闲的读连接；返回值和回调语义同 DbExecutor::submit
+    qint64 submit(Task task, Callback callback = {});
+    QJsonObject run_blocking(Task task);
+
+    auto reader_count() const -> int { return static_cast<int>(m_readers.size()); }
+    auto readers() const -> const std::vector<DbExecutor*>& { return m_readers; }
+
+    void shutdown();
+
+signals:
+    void request_finished(qint64 requestId, const QJsonObject& result);
+
+private:
+    auto least_busy() -> DbExecutor*;
+
+    std::vector<DbExecutor*> m_readers;
+    std::size_t m_next{0}; // 负载相同时轮流分配
+};
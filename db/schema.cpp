@@ -0,0 +1,247 @@
+#include "db/schema.h"
+#include "db/statement_cache.h"
+#include "db/student_search.h"
+
+#include <QStringList>
+#include <QVariant>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+
+namespace {
+    // %1 为表名：升级旧结构时先建成 students_new
+    constexpr const char* kCreateStudentsSql =
+            "CREATE TABLE IF NOT EXISTS %1 ("
+            "student_id INTEGER PRIMARY KEY, "
+            "name TEXT NOT NULL, "
+            "sex TEXT, "
+            "birthdate TEXT, "
+            "age INTEGER, "
+            "enroll_year INTEGER, "
+            "major TEXT, "
+            "class_id INTEGER, "
+            "phone TEXT, "
+            "email TEXT, "
+            "province TEXT, "
+            "city TEXT, "
+            "status TEXT, "
+            "password TEXT "
+            ")";
+
+    // seq 保留家庭成员在学生信息中的顺序
+    constexpr const char* kCreateFamilyMembersSql =
+            "CREATE TABLE IF NOT EXISTS family_members ("
+            "student_id INTEGER NOT NULL REFERENCES students(student_id) ON DELETE CASCADE, "
+            "seq INTEGER NOT NULL, "
+            "name TEXT, "
+            "relationship TEXT, "
+            "phone TEXT, "
+            "email TEXT, "
+            "PRIMARY KEY (student_id, seq)"
+            ") WITHOUT ROWID";
+
+    // 与 json2sql.py 同名同列；应用里只按课程名登记课程，学分和教师允许为空。%1 为表名
+    constexpr const char* kCreateCoursesSql =
+            "CREATE TABLE IF NOT EXISTS %1 ("
+            "course_id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "course_name TEXT NOT NULL UNIQUE, "
+            "credit REAL CHECK (credit > 0), "
+            "teacher_id INTEGER "
+            ")";
+
+    constexpr const char* kCreateGradesSql =
+            "CREATE TABLE IF NOT EXISTS grades ("
+            "grade_id INTEGER PRIMARY KEY AUTOINCREMENT, "
+            "student_id INTEGER NOT NULL REFERENCES students(student_id) ON DELETE CASCADE, "
+            "course_id INTEGER NOT NULL REFERENCES courses(course_id) ON DELETE CASCADE, "
+            "score REAL CHECK (score BETWEEN 0 AND 100), "
+            "gpa REAL, "
+            "term TEXT NOT NULL, "
+            "UNIQUE (student_id, course_id, term)"
+            ")";
+
+    // 只有一行；db_id 区分不同的数据库文件，删库重建后旧快照不会因为版本号碰巧相同而被误用
+    constexpr const char* kCreateDataRevisionSql =
+            "CREATE TABLE IF NOT EXISTS data_revision ("
+            "id INTEGER PRIMARY KEY CHECK (id = 1), "
+            "db_id TEXT NOT NULL, "
+            "revision INTEGER NOT NULL "
+            ")";
+
+    constexpr const char* kInitDataRevisionSql =
+            "INSERT OR IGNORE INTO data_revision (id, db_id, revision) VALUES (1, lower(hex(randomblob(16))), 0)";
+
+    constexpr const char* kBumpDataRevisionSql = "UPDATE data_revision SET revision = revision + 1 WHERE id = 1";
+
+    auto table_columns(QSqlDatabase& db, const QString& table) -> QStringList {
+        QStringList columns;
+        QSqlQuery query(db);
+        if (query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+            while (query.next()) columns << query.value(1).toString();
+        }
+        return columns;
+    }
+
+    // 版本 0 的列并不固定：json2sql.py 建的表没有 family_members，缺的列按空值迁移。
+    // 旧数据中的 JSON 可能为空或损坏，json_valid 失败时同样按空值处理
+    auto migrate_students_sql(const QStringList& columns) -> QString {
+        auto column = [&](const char* name) -> QString {
+            return columns.contains(name) ? QString(name) : QString("NULL");
+        };
+        auto json_field = [&](const char* name, const char* path) -> QString {
+            if (!columns.contains(name)) return "NULL";
+            return QString("CASE WHEN json_valid(%1) THEN json_extract(%1, '%2') END").arg(name, path);
+        };
+        return "INSERT INTO students_new (student_id, name, sex, birthdate, age, enroll_year, major, class_id, "
+               "phone, email, province, city, status, password) SELECT " +
+               QStringList{"student_id", "name", column("sex"), column("birthdate"), column("age"),
+                           column("enroll_year"), column("major"), column("class_id"),
+                           json_field("contact_info", "$.phone"), json_field("contact_info", "$.email"),
+                           json_field("address", "$.province"), json_field("address", "$.city"),
+                           column("status"), column("password")}
+                       .join(", ") +
+               " FROM students";
+    }
+
+    // json2sql.py 建出的 courses 要求 credit / teacher_id 非空，应用登记课程时插不进去
+    auto legacy_courses(QSqlDatabase& db) -> bool {
+        QSqlQuery query(db);
+        if (!query.exec("PRAGMA table_info(courses)")) return false;
+        while (query.next()) {
+            const QString column = query.value(1).toString();
+            if ((column == "credit" || column == "teacher_id") && query.value(3).toBool()) return true;
+        }
+        return false;
+    }
+
+    constexpr const char* kMigrateFamilyMembersSql =
+            "INSERT INTO family_members (student_id, seq, name, relationship, phone, email) "
+            "SELECT s.student_id, CAST(j.key AS INTEGER), "
+            "json_extract(j.value, '$.name'), json_extract(j.value, '$.relationship'), "
+            "json_extract(j.value, '$.contactInfo.phone'), json_extract(j.value, '$.contactInfo.email') "
+            "FROM students s, json_each(CASE WHEN json_valid(s.family_members) THEN s.family_members ELSE '[]' END) j "
+            "WHERE json_type(j.value) = 'object'";
+
+    auto result(bool success, const QString& message, int from) -> QJsonObject {
+        QJsonObject obj;
+        obj["success"] = success;
+        obj["from"]    = from;
+        if (!message.isEmpty()) obj["message"] = message;
+        return obj;
+    }
+
+    bool exec_all(QSqlDatabase& db, const QStringList& statements, QString& error) {
+        QSqlQuery query(db);
+        for (const QString& sql : statements) {
+            if (!query.exec(sql)) {
+                error = query.lastError().text();
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+auto schema_version(QSqlDatabase& db) -> int {
+    QSqlQuery query(db);
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+auto migrate_schema(QSqlDatabase& db) -> QJsonObject {
+    if (!db.isOpen()) return result(false, "数据库未连接", 0);
+
+    const int from = schema_version(db);
+    if (from >= kSchemaVersion) return result(true, QString(), from);
+
+    QStringList statements;
+    if (from < 1) {
+        // 版本 0 可能是全新的数据库，也可能是旧的 JSON 列结构
+        const QStringList columns = table_columns(db, "students");
+        if (columns.contains("contact_info")) {
+            // 新表以 students_new 建好、填入数据后再删旧表并改名。若把旧表改名为 students_v0，
+            // json2sql.py 建出的 grades 里的 REFERENCES students 会被 SQLite 一起改掉，删表后就悬空了
+            statements << QString(kCreateStudentsSql).arg("students_new")
+                       << kCreateFamilyMembersSql
+                       << migrate_students_sql(columns);
+            if (columns.contains("family_members")) statements << kMigrateFamilyMembersSql;
+            statements << "DROP TABLE students"
+                       << "ALTER TABLE students_new RENAME TO students";
+        } else {
+            statements << QString(kCreateStudentsSql).arg("students")
+                       << kCreateFamilyMembersSql;
+        }
+    }
+    if (from < 2) {
+        statements << QString(kCreateCoursesSql).arg("courses")
+                   << kCreateGradesSql;
+        // json2sql.py 建出的 grades 没有 gpa 列
+        if (db.tables().contains("grades") && !db.record("grades").contains("gpa")) {
+            statements << "ALTER TABLE grades ADD COLUMN gpa REAL";
+        }
+    }
+    if (from < 3) {
+        statements << kCreateStudentsFtsSql;
+    }
+    if (from < 4) {
+        statements << kCreateDataRevisionSql
+                   << kInitDataRevisionSql;
+    }
+    if (from < 5 && legacy_courses(db)) {
+        // 与 students 一样建好新表再改名，grades 里的 REFERENCES courses 保持不变；course_id 原样保留
+        statements << QString(kCreateCoursesSql).arg("courses_new")
+                   << "INSERT INTO courses_new (course_id, course_name, credit, teacher_id) "
+                      "SELECT course_id, course_name, credit, teacher_id FROM courses"
+                   << "DROP TABLE courses"
+                   << "ALTER TABLE courses_new RENAME TO courses";
+    }
+    statements << QString("PRAGMA user_version = %1").arg(kSchemaVersion);
+
+    if (!db.transaction()) {
+        return result(false, "开启事务失败: " + db.lastError().text(), from);
+    }
+    QString error;
+    if (!exec_all(db, statements, error)) {
+        db.rollback();
+        return result(false, "升级数据库结构失败: " + error, from);
+    }
+    // 索引里的汉字 n-gram 只能在 C++ 里生成，建表后逐行填充
+    if (from < 3 && !rebuild_search_index(db, error)) {
+        db.rollback();
+        return result(false, "建立搜索索引失败: " + error, from);
+    }
+    if (!db.commit()) {
+        return result(false, "提交数据库结构升级失败: " + db.lastError().text(), from);
+    }
+    return result(true, QString(), from);
+}
+
+bool bump_data_revision(QSqlDatabase& db, QString& error) {
+    StatementCache& cache = StatementCache::of(db);
+    StatementCache::Statement* bump = cache.get(kBumpDataRevisionSql);
+    if (!bump) {
+        error = cache.last_error();
+        return false;
+    }
+    if (!bump->exec()) {
+        error = "更新数据版本失败: " + bump->query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+auto read_data_revision(QSqlDatabase& db) -> QJsonObject {
+    QJsonObject result;
+    result["success"] = false;
+    QSqlQuery query(db);
+    if (!query.exec("SELECT db_id, revision FROM data_revision WHERE id = 1") || !query.next()) {
+        result["message"] = "读取数据版本失败: " + query.lastError().text();
+        return result;
+    }
+    result["success"]  = true;
+    result["dbId"]     = query.value(0).toString();
+    result["revision"] = query.value(1).toLongLong();
+    return result;
+}
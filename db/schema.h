@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QtSql/QSqlDatabase>
+
+// 数据库结构版本，记录在 PRAGMA user_version 中。
+//   0: students 表把 contact_info / address / family_members 存成 JSON 文本（json2sql.py 建的表没有 family_members 列）
+//   1: 联系方式和地址拆成普通列，家庭成员放到 family_members 子表
+//   2: 增加 courses / grades 表保存成绩（结构同 sql_link/json2sql.py，grades 多一列 gpa）
+//   3: 增加 FTS5 全文索引 students_fts
+//   4: 增加 data_revision 表（数据库标识 + 数据版本号），用来判断启动快照是否过期
+//   5: json2sql.py 建出的 courses 表重建为学分、教师可空的结构
+inline constexpr int kSchemaVersion = 5;
+
+auto schema_version(QSqlDatabase& db) -> int;
+
+// 建表或把旧结构原地升级到 kSchemaVersion；整个升级在一个事务内完成。
+// 返回 {"success": bool, "message": 失败原因, "from": 升级前的版本}
+auto migrate_schema(QSqlDatabase& db) -> QJsonObject;
+
+// 修改学生数据的事务在提交前调用一次，把数据版本号加一。
+// 每个事务只更新一行，不用逐行触发器，批量导入不受影响
+bool bump_data_revision(QSqlDatabase& db, QString& error);
+
+// 返回 {"success", "message", "dbId": 建库时生成的随机标识, "revision": 数据版本号}
+auto read_data_revision(QSqlDatabase& db) -> QJsonObject;
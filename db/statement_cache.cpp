@@ -0,0 +1,119 @@
+#include "db/statement_cache.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QtSql/QSqlError>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // 按连接名索引；连接本身只在所属线程上使用
+    thread_local std::map<QString, std::unique_ptr<StatementCache>> t_caches;
+
+    // 所有线程上的缓存，供其它线程读统计；缓存在析构时登记注销
+    QMutex g_registryMutex;
+    std::map<QString, const StatementCache*> g_registry;
+
+    template<typename F>
+    bool timed(std::atomic<qint64>& count, std::atomic<qint64>& totalNs, F&& run) {
+        QElapsedTimer timer;
+        timer.start();
+        const bool ok = run();
+        totalNs.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+    auto empty_stats(const QString& connectionName) -> QJsonObject {
+        QJsonObject stats;
+        stats["connection"] = connectionName;
+        stats["prepared"]   = 0;
+        stats["statements"] = QJsonArray();
+        return stats;
+    }
+}
+
+bool StatementCache::Statement::exec() {
+    return timed(execCount, totalNs, [this] { return query.exec(); });
+}
+
+bool StatementCache::Statement::exec_batch() {
+    return timed(execCount, totalNs, [this] { return query.execBatch(); });
+}
+
+StatementCache::StatementCache(const QSqlDatabase& db) : m_db(db), m_connectionName(db.connectionName()) {
+    QMutexLocker lock(&g_registryMutex);
+    g_registry[m_connectionName] = this;
+}
+
+StatementCache::~StatementCache() {
+    QMutexLocker lock(&g_registryMutex);
+    auto it = g_registry.find(m_connectionName);
+    if (it != g_registry.end() && it->second == this) g_registry.erase(it);
+}
+
+auto StatementCache::of(const QSqlDatabase& db) -> StatementCache& {
+    auto& cache = t_caches[db.connectionName()];
+    if (!cache) cache = std::make_unique<StatementCache>(db);
+    return *cache;
+}
+
+void StatementCache::release(const QString& connectionName) {
+    t_caches.erase(connectionName);
+}
+
+auto StatementCache::get(const QString& sql) -> Statement* {
+    auto it = m_statements.find(sql);
+    if (it != m_statements.end()) return it->second.get();
+
+    auto statement = std::make_unique<Statement>(m_db);
+    if (!statement->query.prepare(sql)) {
+        m_lastError = statement->query.lastError().text();
+        return nullptr;
+    }
+    ++m_prepareCount;
+    // 只有本线程修改 m_statements，上面的查找不用加锁；插入时挡住其它线程的 stats_to_qjson
+    QMutexLocker lock(&m_mutex);
+    return m_statements.emplace(sql, std::move(statement)).first->second.get();
+}
+
+auto StatementCache::stats_to_qjson() const -> QJsonObject {
+    // 先把计数读成一份快照再排序，排序过程中计数可能还在变
+    struct Entry {
+        const QString* sql;
+        qint64 execCount;
+        qint64 totalNs;
+    };
+    QMutexLocker lock(&m_mutex);
+    std::vector<Entry> sorted;
+    sorted.reserve(m_statements.size());
+    for (const auto& [sql, statement] : m_statements) {
+        sorted.push_back({&sql, statement->execCount.load(std::memory_order_relaxed),
+                          statement->totalNs.load(std::memory_order_relaxed)});
+    }
+    std::sort(sorted.begin(), sorted.end(), [] (const Entry& a, const Entry& b) { return a.totalNs > b.totalNs; });
+
+    QJsonArray statements;
+    for (const Entry& e : sorted) {
+        QJsonObject entry;
+        entry["sql"]       = *e.sql;
+        entry["execCount"] = e.execCount;
+        entry["totalMs"]   = static_cast<double>(e.totalNs) / 1e6;
+        entry["avgUs"]     = e.execCount > 0 ? static_cast<double>(e.totalNs) / 1e3 / static_cast<double>(e.execCount) : 0.0;
+        statements.append(entry);
+    }
+
+    QJsonObject stats;
+    stats["connection"] = m_connectionName;
+    stats["prepared"]   = m_prepareCount.load(std::memory_order_relaxed);
+    stats["statements"] = statements;
+    return stats;
+}
+
+auto StatementCache::stats_to_qjson(const QString& connectionName) -> QJsonObject {
+    // 持有登记表的锁期间缓存不会被析构
+    QMutexLocker lock(&g_registryMutex);
+    auto it = g_registry.find(connectionName);
+    return it != g_registry.end() ? it->second->stats_to_qjson() : empty_stats(connectionName);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+// 每个连接一份的预编译语句缓存：同一条 SQL 文本在一个连接上只 prepare 一次，
+// 之后重新绑定参数直接执行，同时统计每条语句的执行次数和累计耗时。
+//
+// 连接只在打开它的线程上使用，缓存也按线程保存，执行语句不加锁。
+// 统计计数是原子的，其它线程（GUI）可以用 stats_to_qjson(连接名) 直接读取，
+// 不必排到数据库线程的队列里等正在进行的导入或导出；只有登记新语句和读统计时加锁。
+// 关闭连接前必须调用 release()，否则缓存里的 QSqlQuery 会让连接无法移除。
+class StatementCache {
+public:
+    struct Statement {
+        QSqlQuery query;
+        std::atomic<qint64> execCount{0};
+        std::atomic<qint64> totalNs{0};
+
+        explicit Statement(const QSqlDatabase& db) : query(db) {}
+
+        // 计时执行；读完 SELECT 的结果后调用 query.finish() 释放读锁
+        bool exec();
+        bool exec_batch();
+    };
+
+    explicit StatementCache(const QSqlDatabase& db);
+    ~StatementCache();
+    StatementCache(const StatementCache&)            = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // 当前线程上该连接的缓存，不存在时创建
+    static auto of(const QSqlDatabase& db) -> StatementCache&;
+    static void release(const QString& connectionName);
+
+    // 返回已预编译的语句，prepare 失败时返回 nullptr，原因见 last_error()
+    auto get(const QString& sql) -> Statement*;
+    auto last_error() const -> QString { return m_lastError; }
+
+    auto size() const -> std::size_t { return m_statements.size(); }
+    auto prepare_count() const -> qint64 { return m_prepareCount; }
+
+    // {"connection", "prepared", "statements": [{sql, execCount, totalMs, avgUs}]}，按累计耗时降序
+    auto stats_to_qjson() const -> QJsonObject;
+    // 任意线程可调用；该连接还没有缓存时 statements 为空
+    static auto stats_to_qjson(const QString& connectionName) -> QJsonObject;
+
+private:
+    QSqlDatabase m_db;
+    QString m_connectionName;
+    mutable QMutex m_mutex; // 保护其它线程读统计时 m_statements 不被插入
+    std::map<QString, std::unique_ptr<Statement>> m_statements;
+    std::atomic<qint64> m_prepareCount{0};
+    QString m_lastError;
+};
@@ -0,0 +1,82 @@
+#include "db/storage_profile.h"
+
+#include <QSettings>
+#include <QStringList>
+#include <QVariant>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+auto durable_storage_profile() -> StorageProfile {
+    StorageProfile profile;
+    profile.name          = "durable";
+    profile.journalMode   = "WAL";
+    profile.synchronous   = "FULL";
+    profile.cacheSizeKiB  = 16 * 1024;
+    profile.mmapSize      = 0;
+    profile.tempStore     = "DEFAULT";
+    profile.busyTimeoutMs = 5000;
+    return profile;
+}
+
+auto fast_storage_profile() -> StorageProfile {
+    StorageProfile profile;
+    profile.name          = "fast";
+    profile.journalMode   = "WAL";
+    profile.synchronous   = "NORMAL";
+    profile.cacheSizeKiB  = 64 * 1024;
+    profile.mmapSize      = 256LL * 1024 * 1024;
+    profile.tempStore     = "MEMORY";
+    profile.busyTimeoutMs = 5000;
+    return profile;
+}
+
+auto storage_profile_by_name(const QString& name) -> StorageProfile {
+    if (name.compare("fast", Qt::CaseInsensitive) == 0) return fast_storage_profile();
+    return durable_storage_profile();
+}
+
+auto configured_storage_profile() -> StorageProfile {
+    QSettings settings;
+    return storage_profile_by_name(settings.value("database/storageProfile", "durable").toString());
+}
+
+auto reader_storage_profile(const StorageProfile& profile) -> StorageProfile {
+    StorageProfile reader = profile;
+    reader.journalMode.clear();
+    reader.queryOnly = true;
+    return reader;
+}
+
+auto apply_storage_profile(QSqlDatabase& db, const StorageProfile& profile) -> QJsonObject {
+    QJsonObject result;
+    if (!db.isOpen()) {
+        result["success"] = false;
+        result["message"] = "数据库未连接";
+        return result;
+    }
+
+    // busy_timeout 放在最前，切换 WAL 时可能要等别的连接
+    QStringList pragmas = {QString("PRAGMA busy_timeout = %1").arg(profile.busyTimeoutMs)};
+    if (!profile.journalMode.isEmpty()) {
+        pragmas << QString("PRAGMA journal_mode = %1").arg(profile.journalMode);
+    }
+    pragmas << QString("PRAGMA synchronous = %1").arg(profile.synchronous)
+            << QString("PRAGMA cache_size = %1").arg(-profile.cacheSizeKiB)
+            << QString("PRAGMA mmap_size = %1").arg(profile.mmapSize)
+            << QString("PRAGMA temp_store = %1").arg(profile.tempStore)
+            << QString("PRAGMA query_only = %1").arg(profile.queryOnly ? 1 : 0);
+    QSqlQuery query(db);
+    for (const QString& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            result["success"] = false;
+            result["message"] = pragma + " 失败: " + query.lastError().text();
+            return result;
+        }
+        // journal_mode 会返回实际模式，内存数据库等情况下不一定是 WAL
+        if (pragma.contains("journal_mode") && query.next()) {
+            result["journalMode"] = query.value(0).toString();
+        }
+    }
+    result["success"] = true;
+    return result;
+}
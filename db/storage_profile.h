@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+
+// 打开连接时设置的 SQLite PRAGMA。除 journal_mode 外都只对当前连接生效，
+// 所以每个连接打开后都要重新应用一次。
+struct StorageProfile {
+    QString name{"default"};
+    QString journalMode{"DELETE"};  // DELETE / WAL / ...，为空时不设置
+    QString synchronous{"FULL"};    // OFF / NORMAL / FULL / EXTRA
+    int cacheSizeKiB{2000};         // 写成 cache_size = -N
+    qint64 mmapSize{0};             // 字节，0 表示不用 mmap
+    QString tempStore{"DEFAULT"};   // DEFAULT / FILE / MEMORY
+    int busyTimeoutMs{0};
+    bool queryOnly{false};          // 只读连接，任何写入都会失败
+};
+
+// 保守配置：WAL + synchronous=FULL，每次提交都落盘
+auto durable_storage_profile() -> StorageProfile;
+// 吞吐优先：WAL + synchronous=NORMAL、大缓存和 mmap。
+// 断电可能丢最后几次提交，但数据库文件不会损坏
+auto fast_storage_profile() -> StorageProfile;
+
+// "durable" / "fast"，无法识别时返回 durable
+auto storage_profile_by_name(const QString& name) -> StorageProfile;
+
+// 从 QSettings 的 database/storageProfile 读取，默认 durable
+auto configured_storage_profile() -> StorageProfile;
+
+// 同一配置的只读版本：不改日志模式（由写连接负责），打开 query_only
+auto reader_storage_profile(const StorageProfile& profile) -> StorageProfile;
+
+// 返回 {"success": bool, "message": 失败原因, "journalMode": 实际生效的日志模式}
+auto apply_storage_profile(QSqlDatabase& db, const StorageProfile& profile) -> QJsonObject;
@@ -0,0 +1,190 @@
+#include "db/student_search.h"
+
+#include <QJsonArray>
+#include <QStringList>
+#include <QVariant>
+#include <QtSql/QSqlError>
+
+namespace {
+    // 只看基本多文种平面内的 CJK 统一汉字，姓名里用到的字基本都在这里
+    bool is_han(QChar c) {
+        const char16_t u = c.unicode();
+        return (u >= 0x3400 && u <= 0x4DBF) || (u >= 0x4E00 && u <= 0x9FFF) || (u >= 0xF900 && u <= 0xFAFF);
+    }
+
+    // 把 text 切成连续汉字段和其它段
+    template<typename F>
+    void for_each_run(const QString& text, F&& f) {
+        qsizetype start = 0;
+        while (start < text.size()) {
+            const bool han = is_han(text[start]);
+            qsizetype end = start + 1;
+            while (end < text.size() && is_han(text[end]) == han) ++end;
+            f(text.mid(start, end - start), han);
+            start = end;
+        }
+    }
+
+    auto quoted(const QString& text) -> QString {
+        QString escaped = text;
+        escaped.replace('"', "\"\"");
+        return '"' + escaped + '"';
+    }
+
+    bool has_word_char(const QString& text) {
+        for (QChar c : text) {
+            if (c.isLetterOrNumber()) return true;
+        }
+        return false;
+    }
+
+    void bind_index_row(QSqlQuery& upsert, qint64 id, const QString& name, const QString& major,
+                        const QString& email, const QString& phone, const QString& address) {
+        upsert.bindValue(":id", id);
+        upsert.bindValue(":name", name);
+        upsert.bindValue(":major", major);
+        upsert.bindValue(":email", email);
+        upsert.bindValue(":phone", phone);
+        upsert.bindValue(":address", address);
+        upsert.bindValue(":grams", han_ngrams(name + ' ' + major + ' ' + address));
+    }
+
+    // 命中字段和片段：取第一个包含查询中某个词的字段
+    void describe_hit(QJsonObject& hit, const QStringList& fields, const QStringList& values, const QStringList& words) {
+        for (qsizetype i = 0; i < fields.size(); ++i) {
+            for (const QString& word : words) {
+                const qsizetype pos = values[i].indexOf(word, 0, Qt::CaseInsensitive);
+                if (pos < 0) continue;
+                QString snippet = values[i];
+                snippet.insert(pos + word.size(), ']');
+                snippet.insert(pos, '[');
+                hit["field"]   = fields[i];
+                hit["snippet"] = snippet;
+                return;
+            }
+        }
+        // 汉字不相邻时只有 grams 命中，退回到姓名
+        hit["field"]   = fields.first();
+        hit["snippet"] = values.first();
+    }
+}
+
+auto han_ngrams(const QString& text) -> QString {
+    QStringList grams;
+    for_each_run(text, [&] (const QString& run, bool han) {
+        if (!han) return;
+        for (qsizetype i = 0; i < run.size(); ++i) {
+            grams << run.mid(i, 1);
+            if (i + 1 < run.size()) grams << run.mid(i, 2);
+        }
+    });
+    return grams.join(' ');
+}
+
+auto search_match_expression(const QString& query) -> QString {
+    QStringList terms;
+    for (const QString& word : query.simplified().split(' ', Qt::SkipEmptyParts)) {
+        for_each_run(word, [&] (const QString& run, bool han) {
+            if (han) {
+                if (run.size() == 1) {
+                    terms << "grams : " + quoted(run);
+                    return;
+                }
+                QStringList bigrams;
+                for (qsizetype i = 0; i + 1 < run.size(); ++i) bigrams << quoted(run.mid(i, 2));
+                terms << "grams : (" + bigrams.join(' ') + ")";
+            } else if (has_word_char(run)) {
+                // 每个词都按前缀匹配：输入到一半能出结果，学号、电话只记得开头几位也能搜到
+                terms << "{name major email phone address} : " + quoted(run) + "*";
+            }
+        });
+    }
+    return terms.join(" AND ");
+}
+
+bool index_student(StatementCache::Statement& upsert, const Stu_withScore& student) {
+    bind_index_row(upsert.query, student.get_id(),
+                   QString::fromStdString(student.get_name()),
+                   QString::fromStdString(student.get_major()),
+                   QString::fromStdString(student.get_contact().email),
+                   QString::fromStdString(student.get_contact().phone),
+                   QString::fromStdString(student.get_address().province.str() + " " + student.get_address().city.str()));
+    return upsert.exec();
+}
+
+bool rebuild_search_index(QSqlDatabase& db, QString& error) {
+    StatementCache& cache = StatementCache::of(db);
+    StatementCache::Statement* upsert = cache.get(kIndexStudentSql);
+    if (!upsert) {
+        error = cache.last_error();
+        return false;
+    }
+    // 只在升级时执行一次，不进缓存
+    QSqlQuery select(db);
+    select.setForwardOnly(true);
+    if (!select.exec("DELETE FROM students_fts")
+        || !select.exec("SELECT student_id, name, major, email, phone, province, city FROM students")) {
+        error = select.lastError().text();
+        return false;
+    }
+    while (select.next()) {
+        bind_index_row(upsert->query, select.value(0).toLongLong(), select.value(1).toString(),
+                       select.value(2).toString(), select.value(3).toString(), select.value(4).toString(),
+                       select.value(5).toString() + ' ' + select.value(6).toString());
+        if (!upsert->exec()) {
+            error = upsert->query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+auto search_students(QSqlDatabase& db, const QString& query, int limit) -> QJsonObject {
+    QJsonObject result;
+    if (!db.isOpen()) {
+        result["success"] = false;
+        result["message"] = "数据库未连接";
+        return result;
+    }
+
+    QJsonArray hits;
+    const QString match = search_match_expression(query);
+    if (!match.isEmpty()) {
+        // bm25 越小越相关；姓名和汉字 n-gram 权重最高
+        StatementCache& cache = StatementCache::of(db);
+        StatementCache::Statement* statement =
+                cache.get("SELECT rowid, name, major, email, phone, address, "
+                          "bm25(students_fts, 10.0, 4.0, 2.0, 2.0, 1.0, 8.0) AS score "
+                          "FROM students_fts WHERE students_fts MATCH :match ORDER BY score LIMIT :limit");
+        if (statement) {
+            statement->query.bindValue(":match", match);
+            statement->query.bindValue(":limit", qBound(1, limit, 1000));
+        }
+        if (!statement || !statement->exec()) {
+            result["success"] = false;
+            result["message"] = "搜索失败: " + (statement ? statement->query.lastError().text() : cache.last_error());
+            return result;
+        }
+        QSqlQuery& select = statement->query;
+
+        const QStringList fields = {"name", "major", "email", "phone", "address"};
+        const QStringList words  = query.simplified().split(' ', Qt::SkipEmptyParts);
+        while (select.next()) {
+            QJsonObject hit;
+            hit["id"]    = select.value(0).toLongLong();
+            hit["name"]  = select.value(1).toString();
+            hit["major"] = select.value(2).toString();
+            hit["score"] = -select.value(6).toDouble();
+            describe_hit(hit, fields,
+                         {select.value(1).toString(), select.value(2).toString(), select.value(3).toString(),
+                          select.value(4).toString(), select.value(5).toString()},
+                         words);
+            hits.append(hit);
+        }
+        select.finish();
+    }
+
+    result["success"] = true;
+    result["results"] = hits;
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "db/statement_cache.h"
+#include "struct/stu_with_score.h"
+
+#include <QJsonObject>
+#include <QString>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+// 学生全文检索：students_fts 是 FTS5 表，rowid 即学号。
+// unicode61 会把一串连续汉字当成一个词，搜“三丰”找不到“张三丰”，
+// 所以另存一列 grams，放汉字的单字和相邻二字组，中文查询只匹配这一列。
+// 索引由 student_sql / BulkImporter 在写学生的同一事务内维护。
+
+inline constexpr const char* kCreateStudentsFtsSql =
+        "CREATE VIRTUAL TABLE IF NOT EXISTS students_fts USING fts5("
+        "name, major, email, phone, address, grams, tokenize = 'unicode61')";
+
+inline constexpr const char* kIndexStudentSql =
+        "INSERT OR REPLACE INTO students_fts (rowid, name, major, email, phone, address, grams) "
+        "VALUES (:id, :name, :major, :email, :phone, :address, :grams)";
+
+inline constexpr const char* kUnindexStudentSql =
+        "DELETE FROM students_fts WHERE rowid = :id";
+
+// 文本中每段连续汉字的单字和二字组，空格分隔
+auto han_ngrams(const QString& text) -> QString;
+
+// 把用户输入转成 FTS5 MATCH 表达式，输入中没有可检索内容时返回空串
+auto search_match_expression(const QString& query) -> QString;
+
+// 用预编译好的 kIndexStudentSql 写入该学生的索引行
+bool index_student(StatementCache::Statement& upsert, const Stu_withScore& student);
+
+// 按 students 表重建整个索引，用于建表后首次填充
+bool rebuild_search_index(QSqlDatabase& db, QString& error);
+
+// 返回 {"success": bool, "message": 失败原因, "results": [{id, name, major, field, snippet, score}]}
+// 按相关度排序；snippet 是命中字段的文本，命中部分用 [ ] 标出
+auto search_students(QSqlDatabase& db, const QString& query, int limit) -> QJsonObject;
@@ -0,0 +1,413 @@
+#include "db/student_sql.h"
+#include "db/schema.h"
+#include "db/statement_cache.h"
+#include "db/student_search.h"
+
+#include <QDate>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QVariant>
+#include <QtSql/QSqlError>
+
+#include <unordered_map>
+
+namespace {
+    // 列顺序与 kSelectStudentsSql 一致，按下标取值避免逐行查列名
+    enum Column {
+        ColId, ColName, ColSex, ColBirthdate, ColEnrollYear, ColMajor, ColClass,
+        ColPhone, ColEmail, ColProvince, ColCity, ColStatus,
+        ColFamilySeq, ColFamilyName, ColFamilyRelationship, ColFamilyPhone, ColFamilyEmail
+    };
+
+    constexpr const char* kSelectStudentsSql =
+            "SELECT s.student_id, s.name, s.sex, s.birthdate, s.enroll_year, s.major, s.class_id, "
+            "s.phone, s.email, s.province, s.city, s.status, "
+            "f.seq, f.name, f.relationship, f.phone, f.email "
+            "FROM students s LEFT JOIN family_members f ON f.student_id = s.student_id ";
+
+    auto sql_result(bool success, const QString& message = QString()) -> QJsonObject {
+        QJsonObject result;
+        result["success"] = success;
+        if (!message.isEmpty()) result["message"] = message;
+        return result;
+    }
+
+    auto not_open() -> QJsonObject {
+        return sql_result(false, "数据库未连接");
+    }
+
+    auto text(const QSqlQuery& query, int column) -> std::string {
+        return query.value(column).toString().toStdString();
+    }
+
+    auto student_from_row(const QSqlQuery& query) -> Stu_withScore {
+        Stu_withScore student;
+        student.set_id(query.value(ColId).toLongLong());
+        student.set_name(text(query, ColName));
+        student.set_sex(query.value(ColSex).toString() == "男" ? Sex::Male : Sex::Female);
+        QDate date = query.value(ColBirthdate).toDate();
+        student.set_birthdate({date.year(), date.month(), date.day()});
+        student.set_enroll_year(query.value(ColEnrollYear).toInt());
+        student.set_major(text(query, ColMajor));
+        student.set_class(query.value(ColClass).toInt());
+        student.set_contact({text(query, ColPhone), text(query, ColEmail)});
+        student.set_address({text(query, ColProvince), text(query, ColCity)});
+        student.set_status(status_from_qjson_string(query.value(ColStatus).toString()));
+        return student;
+    }
+
+    // JOIN 结果中同一学生的行是连续的，每行最多带一个家庭成员
+    void read_students(QSqlQuery& query, std::vector<Stu_withScore>& out) {
+        bool first   = true;
+        long current = 0;
+        while (query.next()) {
+            const long id = query.value(ColId).toLongLong();
+            if (first || id != current) {
+                out.push_back(student_from_row(query));
+                current = id;
+                first   = false;
+            }
+            if (!query.isNull(ColFamilySeq)) {
+                out.back().add_family_member({text(query, ColFamilyName),
+                                              text(query, ColFamilyRelationship),
+                                              {text(query, ColFamilyPhone), text(query, ColFamilyEmail)}});
+            }
+        }
+    }
+
+    constexpr const char* kSelectGradesSql =
+            "SELECT g.student_id, c.course_name, g.score, g.gpa, g.course_id "
+            "FROM grades g JOIN courses c ON c.course_id = g.course_id ";
+
+    // 数据库的 course_id → CourseId，每门课只转换、查找一次课程名
+    class CourseIdCache {
+    public:
+        auto get(const QSqlQuery& query) -> CourseId {
+            const qint64 dbId = query.value(4).toLongLong();
+            auto it           = m_ids.find(dbId);
+            if (it == m_ids.end()) it = m_ids.emplace(dbId, intern_course(text(query, 1))).first;
+            return it->second;
+        }
+
+    private:
+        std::unordered_map<qint64, CourseId> m_ids;
+    };
+
+    // 两边都按学号升序，按顺序归并
+    void read_grades(QSqlQuery& query, std::vector<Stu_withScore>& students) {
+        auto it = students.begin();
+        CourseIdCache courses;
+        while (query.next()) {
+            const long id = query.value(0).toLongLong();
+            while (it != students.end() && it->get_id() < id) ++it;
+            if (it == students.end()) break;
+            if (it->get_id() != id) continue; // 学生已不存在的孤立成绩
+            it->add_score(courses.get(query), Score(query.value(2).toDouble(), query.value(3).toDouble()));
+        }
+    }
+
+    // 取当前连接上缓存的预编译语句，prepare 失败时把原因写进 error
+    auto cached(QSqlDatabase& db, const QString& sql, QString& error) -> StatementCache::Statement* {
+        StatementCache& cache = StatementCache::of(db);
+        StatementCache::Statement* statement = cache.get(sql);
+        if (!statement) error = cache.last_error();
+        return statement;
+    }
+
+    // 执行只按学号绑定的语句
+    bool exec_for_id(QSqlDatabase& db, const char* sql, long studentId, QString& error) {
+        StatementCache::Statement* statement = cached(db, sql, error);
+        if (!statement) return false;
+        statement->query.bindValue(":id", QVariant::fromValue(studentId));
+        if (!statement->exec()) {
+            error = statement->query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+
+    // 在一个事务内执行 body，body 返回 false 时回滚
+    template<typename F>
+    auto in_transaction(QSqlDatabase& db, const QString& what, F&& body) -> QJsonObject {
+        if (!db.transaction()) {
+            return sql_result(false, what + ": " + db.lastError().text());
+        }
+        QString error;
+        if (!body(error) || !bump_data_revision(db, error)) {
+            db.rollback();
+            return sql_result(false, what + ": " + error);
+        }
+        if (!db.commit()) {
+            return sql_result(false, what + ": " + db.lastError().text());
+        }
+        return sql_result(true);
+    }
+
+    bool replace_family_members(QSqlDatabase& db, const Stu_withScore& student, QString& error) {
+        if (!exec_for_id(db, kDeleteFamilyMembersSql, student.get_id(), error)) return false;
+        StatementCache::Statement* insert = cached(db, kInsertFamilyMemberSql, error);
+        if (!insert) return false;
+        if (!insert_family_members(*insert, student)) {
+            error = insert->query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+
+    bool reindex_student(QSqlDatabase& db, const Stu_withScore& student, QString& error) {
+        StatementCache::Statement* upsert = cached(db, kIndexStudentSql, error);
+        if (!upsert) return false;
+        if (!index_student(*upsert, student)) {
+            error = upsert->query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+
+    // 批量 upsert 当前成绩，再删掉本学期中已经被删除的课程
+    bool write_scores(QSqlDatabase& db, const Stu_withScore& student, QString& error) {
+        StatementCache::Statement* findCourse   = cached(db, kSelectCourseIdSql, error);
+        StatementCache::Statement* insertCourse = findCourse ? cached(db, kInsertCourseSql, error) : nullptr;
+        StatementCache::Statement* upsertGrade  = insertCourse ? cached(db, kUpsertGradeSql, error) : nullptr;
+        if (!upsertGrade) return false;
+        if (!upsert_scores(*findCourse, *insertCourse, *upsertGrade, student, error)) return false;
+
+        QJsonArray courses;
+        for (const auto& [course, score] : student.get_all_scores()) {
+            courses.append(QString::fromStdString(course));
+        }
+        StatementCache::Statement* stale = cached(db, kDeleteStaleGradesSql, error);
+        if (!stale) return false;
+        stale->query.bindValue(":id", QVariant::fromValue(student.get_id()));
+        stale->query.bindValue(":term", kScoreTerm);
+        stale->query.bindValue(":courses", QString::fromUtf8(QJsonDocument(courses).toJson(QJsonDocument::Compact)));
+        if (!stale->exec()) {
+            error = stale->query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+
+    // 课程名对应的 course_id，还没有这门课时先登记；失败时返回无效值，原因写入 error
+    auto find_or_insert_course(StatementCache::Statement& find, StatementCache::Statement& insert,
+                               const QString& course, QString& error) -> QVariant {
+        find.query.bindValue(":course", course);
+        if (!find.exec()) {
+            error = QString("查询课程 %1 失败: %2").arg(course, find.query.lastError().text());
+            return {};
+        }
+        QVariant id = find.query.next() ? find.query.value(0) : QVariant();
+        find.query.finish();
+        if (id.isValid()) return id;
+
+        insert.query.bindValue(":course", course);
+        if (!insert.exec()) {
+            error = QString("登记课程 %1 失败: %2").arg(course, insert.query.lastError().text());
+            return {};
+        }
+        id = insert.query.lastInsertId();
+        if (!id.isValid()) error = QString("课程 %1 没有取得 course_id").arg(course);
+        return id;
+    }
+
+    // 写学生行本身，新增时还要写初始密码
+    bool write_student_row(QSqlDatabase& db, bool insert, const Stu_withScore& student, QString& error) {
+        StatementCache::Statement* statement = cached(db, insert ? kInsertStudentSql : kUpdateStudentSql, error);
+        if (!statement) return false;
+        bind_student_columns(statement->query, student);
+        if (insert) {
+            statement->query.bindValue(":password", "password"); // Placeholder for password
+        }
+        if (!statement->exec()) {
+            error = statement->query.lastError().text();
+            return false;
+        }
+        return true;
+    }
+}
+
+void bind_student_columns(QSqlQuery& query, const Stu_withScore& student) {
+    query.bindValue(":id", QVariant::fromValue(student.get_id()));
+    query.bindValue(":name", QString::fromStdString(student.get_name()));
+    query.bindValue(":sex", student.get_sex() == Sex::Male ? "男" : "女");
+    query.bindValue(":birthdate",
+                    QDate(student.get_birthdate().year, student.get_birthdate().month, student.get_birthdate().day));
+    query.bindValue(":age", student.get_age());
+    query.bindValue(":enroll_year", student.get_enroll_year());
+    query.bindValue(":major", QString::fromStdString(student.get_major()));
+    query.bindValue(":class_id", student.get_class());
+    query.bindValue(":phone", QString::fromStdString(student.get_contact().phone));
+    query.bindValue(":email", QString::fromStdString(student.get_contact().email));
+    query.bindValue(":province", QString::fromStdString(student.get_address().province));
+    query.bindValue(":city", QString::fromStdString(student.get_address().city));
+    query.bindValue(":status", status_to_qjson_string(student.get_status()));
+}
+
+bool insert_family_members(StatementCache::Statement& insert, const Stu_withScore& student) {
+    int seq = 0;
+    for (const auto& fm : student.get_family_members()) {
+        insert.query.bindValue(":student_id", QVariant::fromValue(student.get_id()));
+        insert.query.bindValue(":seq", seq++);
+        insert.query.bindValue(":name", QString::fromStdString(fm.name));
+        insert.query.bindValue(":relationship", QString::fromStdString(fm.relationship));
+        insert.query.bindValue(":phone", QString::fromStdString(fm.contactInfo.phone));
+        insert.query.bindValue(":email", QString::fromStdString(fm.contactInfo.email));
+        if (!insert.exec()) return false;
+    }
+    return true;
+}
+
+bool upsert_scores(StatementCache::Statement& findCourse, StatementCache::Statement& insertCourse,
+                   StatementCache::Statement& upsertGrade, const Stu_withScore& student, QString& error) {
+    const auto& scores = student.get_all_scores();
+    if (scores.empty()) return true;
+
+    QVariantList ids, courseIds, values, gpas, terms;
+    for (const auto& [course, score] : scores) {
+        const QVariant courseId = find_or_insert_course(findCourse, insertCourse, QString::fromStdString(course), error);
+        if (!courseId.isValid()) return false;
+        ids << QVariant::fromValue(student.get_id());
+        courseIds << courseId;
+        values << score.score;
+        gpas << score.gpa;
+        terms << kScoreTerm;
+    }
+
+    upsertGrade.query.bindValue(":student_id", ids);
+    upsertGrade.query.bindValue(":course_id", courseIds);
+    upsertGrade.query.bindValue(":score", values);
+    upsertGrade.query.bindValue(":gpa", gpas);
+    upsertGrade.query.bindValue(":term", terms);
+    if (!upsertGrade.exec_batch()) {
+        error = upsertGrade.query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+auto insert_student(QSqlDatabase& db, const Stu_withScore& student) -> QJsonObject {
+    if (!db.isOpen()) return not_open();
+    return in_transaction(db, "保存学生数据失败", [&] (QString& error) {
+        return write_student_row(db, true, student, error) && replace_family_members(db, student, error)
+               && write_scores(db, student, error) && reindex_student(db, student, error);
+    });
+}
+
+auto update_student(QSqlDatabase& db, const Stu_withScore& student) -> QJsonObject {
+    if (!db.isOpen()) return not_open();
+    return in_transaction(db, "更新学生数据失败", [&] (QString& error) {
+        return write_student_row(db, false, student, error) && replace_family_members(db, student, error)
+               && write_scores(db, student, error) && reindex_student(db, student, error);
+    });
+}
+
+auto delete_student(QSqlDatabase& db, long studentId) -> QJsonObject {
+    if (!db.isOpen()) return not_open();
+    return in_transaction(db, "删除学生数据失败", [&] (QString& error) {
+        for (const char* sql : {kUnindexStudentSql, kDeleteGradesSql, kDeleteFamilyMembersSql, kDeleteStudentSql}) {
+            if (!exec_for_id(db, sql, studentId, error)) return false;
+        }
+        return true;
+    });
+}
+
+auto select_all_students(QSqlDatabase& db, std::vector<Stu_withScore>& out) -> QJsonObject {
+    const std::size_t before = out.size();
+    QJsonObject result = for_each_student(db, [&] (Stu_withScore& student) {
+        out.push_back(std::move(student));
+        return true;
+    });
+    if (result["success"].toBool()) result["count"] = static_cast<qint64>(out.size() - before);
+    return result;
+}
+
+auto for_each_student(QSqlDatabase& db, const std::function<bool(Stu_withScore&)>& visit) -> QJsonObject {
+    if (!db.isOpen()) return not_open();
+    QString error;
+    StatementCache::Statement* students = cached(db, QString(kSelectStudentsSql) + "ORDER BY s.student_id, f.seq", error);
+    if (!students || !students->exec()) {
+        return sql_result(false, "加载学生数据失败: " + (students ? students->query.lastError().text() : error));
+    }
+    StatementCache::Statement* grades = cached(db, QString(kSelectGradesSql) + "ORDER BY g.student_id, g.term", error);
+    if (!grades || !grades->exec()) {
+        students->query.finish();
+        return sql_result(false, "加载成绩失败: " + (grades ? grades->query.lastError().text() : error));
+    }
+
+    // 两个游标都按学号升序，成绩游标跟着学生游标前进
+    QSqlQuery& rows   = students->query;
+    QSqlQuery& scores = grades->query;
+    bool scoreValid   = scores.next();
+    CourseIdCache courses;
+    auto complete = [&] (Stu_withScore& student) {
+        const long id = student.get_id();
+        while (scoreValid && scores.value(0).toLongLong() < id) scoreValid = scores.next(); // 孤立成绩
+        while (scoreValid && scores.value(0).toLongLong() == id) {
+            student.add_score(courses.get(scores), Score(scores.value(2).toDouble(), scores.value(3).toDouble()));
+            scoreValid = scores.next();
+        }
+        return visit(student);
+    };
+
+    qint64 count = 0;
+    bool stopped = false;
+    Stu_withScore current;
+    bool hasCurrent = false;
+    while (!stopped && rows.next()) {
+        const long id = rows.value(ColId).toLongLong();
+        if (!hasCurrent || id != current.get_id()) {
+            if (hasCurrent) {
+                ++count;
+                stopped = !complete(current);
+                if (stopped) break;
+            }
+            current    = student_from_row(rows);
+            hasCurrent = true;
+        }
+        if (!rows.isNull(ColFamilySeq)) {
+            current.add_family_member({text(rows, ColFamilyName),
+                                       text(rows, ColFamilyRelationship),
+                                       {text(rows, ColFamilyPhone), text(rows, ColFamilyEmail)}});
+        }
+    }
+    if (!stopped && hasCurrent) {
+        ++count;
+        stopped = !complete(current);
+    }
+    rows.finish();
+    scores.finish();
+
+    QJsonObject result = sql_result(true);
+    result["count"]    = count;
+    result["stopped"]  = stopped;
+    return result;
+}
+
+auto select_student(QSqlDatabase& db, long studentId, Stu_withScore& out) -> QJsonObject {
+    if (!db.isOpen()) return not_open();
+    QString error;
+    StatementCache::Statement* student =
+            cached(db, QString(kSelectStudentsSql) + "WHERE s.student_id = :id ORDER BY f.seq", error);
+    if (student) student->query.bindValue(":id", QVariant::fromValue(studentId));
+    if (!student || !student->exec()) {
+        return sql_result(false, "查询学生失败: " + (student ? student->query.lastError().text() : error));
+    }
+    std::vector<Stu_withScore> found;
+    read_students(student->query, found);
+    student->query.finish();
+    if (found.empty()) {
+        return sql_result(false, QString("未找到ID为 %1 的学生").arg(studentId));
+    }
+
+    StatementCache::Statement* grades =
+            cached(db, QString(kSelectGradesSql) + "WHERE g.student_id = :id ORDER BY g.term", error);
+    if (grades) grades->query.bindValue(":id", QVariant::fromValue(studentId));
+    if (!grades || !grades->exec()) {
+        return sql_result(false, "查询成绩失败: " + (grades ? grades->query.lastError().text() : error));
+    }
+    read_grades(grades->query, found);
+    grades->query.finish();
+    out = std::move(found.front());
+    return sql_result(true);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "db/statement_cache.h"
+#include "struct/stu_with_score.h"
+
+#include <QJsonObject>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+#include <functional>
+#include <vector>
+
+// students 表的 SQL 文本、参数绑定以及基本的增删改查。
+// 所有函数都在调用方给定的连接上执行，由持有该连接的线程调用；
+// 语句取自该连接的 StatementCache，只在第一次使用时 prepare。
+
+inline constexpr const char* kInsertStudentSql =
+        "INSERT INTO students (student_id, name, sex, birthdate, age, enroll_year, major, class_id, phone, email, province, city, status, password) "
+        "VALUES (:id, :name, :sex, :birthdate, :age, :enroll_year, :major, :class_id, :phone, :email, :province, :city, :status, :password)";
+
+// 导入文件中出现重复学号时以最后一条为准，与内存中的 upsert 保持一致。
+// 已有的学生只更新资料列，密码保持不变；:password 只用于新插入的学生
+inline constexpr const char* kUpsertStudentSql =
+        "INSERT INTO students (student_id, name, sex, birthdate, age, enroll_year, major, class_id, phone, email, province, city, status, password) "
+        "VALUES (:id, :name, :sex, :birthdate, :age, :enroll_year, :major, :class_id, :phone, :email, :province, :city, :status, :password) "
+        "ON CONFLICT (student_id) DO UPDATE SET name = excluded.name, sex = excluded.sex, birthdate = excluded.birthdate, "
+        "age = excluded.age, enroll_year = excluded.enroll_year, major = excluded.major, class_id = excluded.class_id, "
+        "phone = excluded.phone, email = excluded.email, province = excluded.province, city = excluded.city, status = excluded.status";
+
+inline constexpr const char* kUpdateStudentSql =
+        "UPDATE students SET name = :name, sex = :sex, birthdate = :birthdate, age = :age, enroll_year = :enroll_year, major = :major, class_id = :class_id, phone = :phone, email = :email, province = :province, city = :city, status = :status WHERE student_id = :id";
+
+inline constexpr const char* kDeleteStudentSql =
+        "DELETE FROM students WHERE student_id = :id";
+
+inline constexpr const char* kInsertFamilyMemberSql =
+        "INSERT INTO family_members (student_id, seq, name, relationship, phone, email) "
+        "VALUES (:student_id, :seq, :name, :relationship, :phone, :email)";
+
+inline constexpr const char* kDeleteFamilyMembersSql =
+        "DELETE FROM family_members WHERE student_id = :id";
+
+// 内存中的成绩不区分学期，统一写在这个学期下；加载时其它学期的成绩也会读入，
+// 同一课程以学期排序靠后的为准
+inline constexpr const char* kScoreTerm = "";
+
+inline constexpr const char* kSelectCourseIdSql =
+        "SELECT course_id FROM courses WHERE course_name = :course";
+
+// 只登记课程名，学分和教师留空
+inline constexpr const char* kInsertCourseSql =
+        "INSERT INTO courses (course_name) VALUES (:course)";
+
+inline constexpr const char* kUpsertGradeSql =
+        "INSERT INTO grades (student_id, course_id, score, gpa, term) "
+        "VALUES (:student_id, :course_id, :score, :gpa, :term) "
+        "ON CONFLICT (student_id, course_id, term) DO UPDATE SET score = excluded.score, gpa = excluded.gpa";
+
+// :courses 为当前课程名组成的 JSON 数组，删除该学期中已不存在的课程成绩
+inline constexpr const char* kDeleteStaleGradesSql =
+        "DELETE FROM grades WHERE student_id = :id AND term = :term AND course_id NOT IN "
+        "(SELECT c.course_id FROM courses c JOIN json_each(:courses) j ON c.course_name = j.value)";
+
+inline constexpr const char* kDeleteGradesSql =
+        "DELETE FROM grades WHERE student_id = :id";
+
+// 绑定 students 表除 :password 以外的所有列
+void bind_student_columns(QSqlQuery& query, const Stu_withScore& student);
+
+// 用预编译好的 kInsertFamilyMemberSql 写入该学生的全部家庭成员
+bool insert_family_members(StatementCache::Statement& insert, const Stu_withScore& student);
+
+// 用预编译好的 kSelectCourseIdSql / kInsertCourseSql 查出或登记课程，再用 kUpsertGradeSql
+// 批量写入该学生的全部成绩；失败时 error 为原因，课程取不到编号时指明是哪门课
+bool upsert_scores(StatementCache::Statement& findCourse, StatementCache::Statement& insertCourse,
+                   StatementCache::Statement& upsertGrade, const Stu_withScore& student, QString& error);
+
+// 以下函数返回 {"success": bool, "message": 失败原因}
+// 写入学生时家庭成员、成绩和搜索索引在同一事务内一并写入
+auto insert_student(QSqlDatabase& db, const Stu_withScore& student) -> QJsonObject;
+auto update_student(QSqlDatabase& db, const Stu_withScore& student) -> QJsonObject;
+auto delete_student(QSqlDatabase& db, long studentId) -> QJsonObject;
+// students LEFT JOIN family_members 一次查询读出全部学生，
+// 再用一次按学号排序的查询把 grades 归并进去
+auto select_all_students(QSqlDatabase& db, std::vector<Stu_withScore>& out) -> QJsonObject;
+// 同样的两条查询，按学号顺序每组装好一个学生就交给 visit，内存中只保留当前学生；
+// visit 返回 false 时提前结束（结果仍为 success，"stopped" 为 true）。
+// 需要一致的快照时由调用方包在事务里
+auto for_each_student(QSqlDatabase& db, const std::function<bool(Stu_withScore&)>& visit) -> QJsonObject;
+// 未找到时 success 为 false
+auto select_student(QSqlDatabase& db, long studentId, Stu_withScore& out) -> QJsonObject;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../struct/json_writer.h"
+
 #include <string>
 #include <variant>
 
@@ -42,6 +44,41 @@ private:
     Content content;
 };
 
+// -- direct JSON output (JsonWriter), same fields as message_to_qjson --
+
+inline auto message_type_json_name(Message::Type type) -> const char* {
+    switch (type) {
+        case Message::Type::Text: return "Text";
+        case Message::Type::Image: return "Image";
+        case Message::Type::Gif: return "Gif";
+        case Message::Type::Video: return "Video";
+        case Message::Type::Emoji: return "Emoji";
+        default: return "Unknown";
+    }
+}
+
+inline void write_json(JsonWriter& w, const Message::Content& content) {
+    auto media = [&] (Message::Type type, const std::string& path) {
+        w.begin_object().field("type", message_type_json_name(type)).field("path", path).end_object();
+    };
+    if (const auto* text = std::get_if<std::string>(&content)) {
+        w.value(*text);
+    } else if (const auto* img = std::get_if<Message::ImageCtn>(&content)) {
+        media(Message::Type::Image, img->path);
+    } else if (const auto* gif = std::get_if<Message::GifCtn>(&content)) {
+        media(Message::Type::Gif, gif->path);
+    } else if (const auto* video = std::get_if<Message::VideoCtn>(&content)) {
+        media(Message::Type::Video, video->path);
+    } else {
+        w.null();
+    }
+}
+
+inline void write_json(JsonWriter& w, const Message& msg) {
+    w.begin_object().field("type", message_type_json_name(msg.get_type()));
+    write_json(w.key("content"), msg.get_content());
+    w.end_object();
+}
 
 #ifdef USE_QTJSON
 
@@ -0,0 +1,104 @@
+#include "io/json_stream_reader.h"
+
+JsonArrayStreamReader::JsonArrayStreamReader(QIODevice* device, qint64 chunkSize)
+    : m_device(device), m_chunkSize(chunkSize > 0 ? chunkSize : 64 * 1024) {}
+
+// 丢弃已消费的前缀并追加一个读取块
+bool JsonArrayStreamReader::fill() {
+    QByteArray chunk = m_device->read(m_chunkSize);
+    if (chunk.isEmpty()) return false;
+    if (m_pos > 0) {
+        m_buf.remove(0, m_pos);
+        m_discarded += m_pos;
+        m_pos = 0;
+    }
+    m_buf.append(chunk);
+    return true;
+}
+
+bool JsonArrayStreamReader::skip_whitespace() {
+    for (;;) {
+        while (m_pos < m_buf.size()) {
+            char c = m_buf.at(m_pos);
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') return true;
+            ++m_pos;
+        }
+        if (!fill()) return false;
+    }
+}
+
+bool JsonArrayStreamReader::fail(const QString& message) {
+    m_state = State::Error;
+    m_error = QString("%1 (偏移 %2)").arg(message).arg(bytes_processed());
+    return false;
+}
+
+bool JsonArrayStreamReader::next(QByteArray& element) {
+    if (m_state == State::Done || m_state == State::Error) return false;
+
+    if (m_state == State::Start) {
+        if (!fill()) return fail("文件为空");
+        // 跳过 UTF-8 BOM
+        if (m_buf.startsWith("\xEF\xBB\xBF")) m_pos = 3;
+        if (!skip_whitespace() || m_buf.at(m_pos) != '[') return fail("根元素必须是数组");
+        ++m_pos;
+        m_state = State::InArray;
+    }
+
+    if (!skip_whitespace()) return fail("数组未闭合");
+    if (m_buf.at(m_pos) == ']') {
+        ++m_pos;
+        m_state = State::Done;
+        return false;
+    }
+    if (m_seenElement) {
+        if (m_buf.at(m_pos) != ',') return fail("数组元素之间缺少逗号");
+        ++m_pos;
+        if (!skip_whitespace()) return fail("数组未闭合");
+    }
+
+    // 扫描一个完整的值：对象/数组按括号深度结束，标量在 ',' 或 ']' 前结束
+    qsizetype off  = 0;
+    int depth      = 0;
+    bool inString  = false;
+    bool escape    = false;
+    for (;;) {
+        if (m_pos + off >= m_buf.size()) {
+            if (!fill()) return fail("数组未闭合");
+            continue;
+        }
+        char ch = m_buf.at(m_pos + off);
+        if (inString) {
+            if (escape) {
+                escape = false;
+            } else if (ch == '\\') {
+                escape = true;
+            } else if (ch == '"') {
+                inString = false;
+                if (depth == 0) {
+                    ++off;
+                    break;
+                }
+            }
+        } else if (ch == '"') {
+            inString = true;
+        } else if (ch == '{' || ch == '[') {
+            ++depth;
+        } else if (ch == '}' || ch == ']') {
+            if (depth == 0) break;
+            if (--depth == 0) {
+                ++off;
+                break;
+            }
+        } else if (ch == ',' && depth == 0) {
+            break;
+        }
+        ++off;
+    }
+
+    if (off == 0) return fail("数组元素为空");
+    element = m_buf.mid(m_pos, off);
+    m_pos += off;
+    m_seenElement = true;
+    return true;
+}
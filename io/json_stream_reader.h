@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QString>
+
+// 逐个元素读取顶层 JSON 数组，不把整个文件读进内存。
+// 每次 next() 只返回当前元素的原始字节，交给 QJsonDocument::fromJson
+// 单独解析；缓冲区大小约为 一个元素 + 一个读取块。
+class JsonArrayStreamReader {
+public:
+    explicit JsonArrayStreamReader(QIODevice* device, qint64 chunkSize = 64 * 1024);
+
+    // 读取下一个元素；数组结束或出错时返回 false，用 has_error() 区分
+    bool next(QByteArray& element);
+
+    auto has_error() const -> bool { return m_state == State::Error; }
+    auto error_string() const -> QString { return m_error; }
+
+    // 已经消费的字节数，用于进度显示
+    auto bytes_processed() const -> qint64 { return m_discarded + m_pos; }
+
+private:
+    enum class State { Start, InArray, Done, Error };
+
+    bool fill();
+    bool skip_whitespace();
+    bool fail(const QString& message);
+
+    QIODevice* m_device;
+    qint64 m_chunkSize;
+    QByteArray m_buf;
+    qsizetype m_pos{0};
+    qint64 m_discarded{0};
+    bool m_seenElement{false};
+    State m_state{State::Start};
+    QString m_error;
+};
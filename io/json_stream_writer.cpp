@@ -0,0 +1,128 @@
+#include "io/json_stream_writer.h"
+
+#include <QJsonDocument>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+struct JsonArrayStreamWriter::Deflater {
+#ifdef HAVE_ZLIB
+    z_stream stream{};
+    QByteArray out;
+    bool initialized{false};
+
+    ~Deflater() {
+        if (initialized) deflateEnd(&stream);
+    }
+#endif
+};
+
+JsonArrayStreamWriter::JsonArrayStreamWriter(QIODevice* device, Style style, bool gzip, qsizetype bufferSize)
+    : m_device(device), m_style(style), m_bufferSize(bufferSize > 0 ? bufferSize : 64 * 1024) {
+    m_buffer.reserve(m_bufferSize);
+    if (gzip) m_deflater = std::make_unique<Deflater>();
+}
+
+JsonArrayStreamWriter::~JsonArrayStreamWriter() = default;
+
+auto JsonArrayStreamWriter::gzip_supported() -> bool {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JsonArrayStreamWriter::begin() {
+    if (m_deflater) {
+#ifdef HAVE_ZLIB
+        // windowBits + 16 生成 gzip 头和尾，而不是裸 zlib 流
+        if (deflateInit2(&m_deflater->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return fail("初始化 gzip 压缩失败");
+        }
+        m_deflater->initialized = true;
+        m_deflater->out.resize(m_bufferSize);
+#else
+        return fail("当前构建不支持 gzip 压缩");
+#endif
+    }
+    return append(m_style == Style::Pretty ? "[\n" : "[");
+}
+
+bool JsonArrayStreamWriter::write(const QJsonObject& element) {
+    if (m_failed) return false;
+
+    QByteArray separator;
+    if (m_count > 0) separator = m_style == Style::Pretty ? ",\n" : ",";
+    if (!separator.isEmpty() && !append(separator)) return false;
+    ++m_count;
+
+    if (m_style == Style::Compact) {
+        return append(QJsonDocument(element).toJson(QJsonDocument::Compact));
+    }
+    // 和整体 toJson(Indented) 的输出保持一致：元素内每行再缩进一级
+    const QByteArray json = QJsonDocument(element).toJson(QJsonDocument::Indented);
+    qsizetype start = 0;
+    while (start < json.size()) {
+        qsizetype end = json.indexOf('\n', start);
+        if (end < 0) end = json.size();
+        if (start > 0 && !append("\n")) return false;
+        if (!append("    ") || !append(json.mid(start, end - start))) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+bool JsonArrayStreamWriter::finish() {
+    if (m_failed) return false;
+    if (!append(m_style == Style::Pretty ? (m_count > 0 ? "\n]\n" : "]\n") : "]")) return false;
+    return flush(true);
+}
+
+bool JsonArrayStreamWriter::append(const QByteArray& bytes) {
+    if (m_failed) return false;
+    m_buffer.append(bytes);
+    return m_buffer.size() < m_bufferSize || flush(false);
+}
+
+bool JsonArrayStreamWriter::flush(bool end) {
+    if (!m_deflater) {
+        const bool ok = write_device(m_buffer.constData(), m_buffer.size());
+        m_buffer.clear();
+        return ok;
+    }
+#ifdef HAVE_ZLIB
+    z_stream& zs = m_deflater->stream;
+    zs.next_in   = reinterpret_cast<Bytef*>(m_buffer.data());
+    zs.avail_in  = static_cast<uInt>(m_buffer.size());
+    int status   = Z_OK;
+    do {
+        zs.next_out  = reinterpret_cast<Bytef*>(m_deflater->out.data());
+        zs.avail_out = static_cast<uInt>(m_deflater->out.size());
+        status       = deflate(&zs, end ? Z_FINISH : Z_NO_FLUSH);
+        if (status == Z_STREAM_ERROR) return fail("gzip 压缩失败");
+        const qint64 produced = m_deflater->out.size() - static_cast<qint64>(zs.avail_out);
+        if (!write_device(m_deflater->out.constData(), produced)) return false;
+    } while (zs.avail_out == 0 || (end && status != Z_STREAM_END));
+    m_buffer.clear();
+    return true;
+#else
+    return fail("当前构建不支持 gzip 压缩");
+#endif
+}
+
+bool JsonArrayStreamWriter::write_device(const char* data, qint64 size) {
+    if (size <= 0) return true;
+    if (m_device->write(data, size) != size) {
+        return fail("写入文件失败: " + m_device->errorString());
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+bool JsonArrayStreamWriter::fail(const QString& message) {
+    m_failed = true;
+    m_error  = message;
+    return false;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QString>
+
+#include <memory>
+
+// 逐个元素写出顶层 JSON 数组，与 JsonArrayStreamReader 对应。
+// 每个元素序列化后立即进入一个固定大小的缓冲区，满了就写到设备，
+// 内存占用与元素总数无关。可选 gzip 压缩（需要 zlib，见 gzip_supported()）。
+//
+// 用法: begin() -> write() ... -> finish()；任何一步失败后 error_string() 给出原因。
+class JsonArrayStreamWriter {
+public:
+    enum class Style { Compact, Pretty };
+
+    JsonArrayStreamWriter(QIODevice* device, Style style, bool gzip = false, qsizetype bufferSize = 64 * 1024);
+    ~JsonArrayStreamWriter();
+
+    static auto gzip_supported() -> bool;
+
+    bool begin();
+    bool write(const QJsonObject& element);
+    bool finish();
+
+    auto count() const -> qint64 { return m_count; }
+    // 写到设备上的字节数（压缩后）
+    auto bytes_written() const -> qint64 { return m_bytesWritten; }
+    auto error_string() const -> QString { return m_error; }
+
+private:
+    struct Deflater;
+
+    bool append(const QByteArray& bytes);
+    bool flush(bool end);
+    bool write_device(const char* data, qint64 size);
+    bool fail(const QString& message);
+
+    QIODevice* m_device;
+    Style m_style;
+    qsizetype m_bufferSize;
+    QByteArray m_buffer;
+    std::unique_ptr<Deflater> m_deflater; // 不压缩时为空
+    qint64 m_count{0};
+    qint64 m_bytesWritten{0};
+    bool m_failed{false};
+    QString m_error;
+};
@@ -0,0 +1,36 @@
+#include "io/student_json_cache.h"
+
+auto StudentJsonCache::get(const Stu_withScore& student) -> QJsonObject {
+    auto it = m_entries.find(student.get_id());
+    if (it != m_entries.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+    QJsonObject obj = stu_with_score_to_qjson(student);
+    m_entries.emplace(student.get_id(), obj);
+    return obj;
+}
+
+void StudentJsonCache::invalidate(long studentId) {
+    m_entries.erase(studentId);
+}
+
+void StudentJsonCache::clear() {
+    m_entries.clear();
+}
+
+void StudentJsonCache::reset_counters() {
+    m_hits   = 0;
+    m_misses = 0;
+}
+
+auto StudentJsonCache::stats_to_qjson() const -> QJsonObject {
+    const quint64 lookups = m_hits + m_misses;
+    QJsonObject stats;
+    stats["entries"] = static_cast<qint64>(m_entries.size());
+    stats["hits"]    = static_cast<qint64>(m_hits);
+    stats["misses"]  = static_cast<qint64>(m_misses);
+    stats["hitRate"] = lookups ? static_cast<double>(m_hits) / static_cast<double>(lookups) : 0.0;
+    return stats;
+}
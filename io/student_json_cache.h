@@ -0,0 +1,36 @@
+#pragma once
+
+#include "struct/stu_with_score.h"
+
+#include <QJsonObject>
+#include <QtGlobal>
+
+#include <unordered_map>
+
+// 每个学生序列化后的 QJsonObject 缓存。QJsonObject 是隐式共享的，
+// 命中时拼进 QJsonArray 只增加引用计数，不会重建嵌套的
+// contact / address / familyMembers / scores。
+//
+// 缓存不感知 StudentStore 的修改：调用方在学生被修改或删除后必须
+// invalidate()，整体替换时 clear()。
+class StudentJsonCache {
+public:
+    // 未命中时调用 stu_with_score_to_qjson 并缓存结果；转换异常原样抛出
+    auto get(const Stu_withScore& student) -> QJsonObject;
+
+    void invalidate(long studentId);
+    void clear();
+
+    auto size() const -> std::size_t { return m_entries.size(); }
+    auto hits() const -> quint64 { return m_hits; }
+    auto misses() const -> quint64 { return m_misses; }
+    void reset_counters();
+
+    // {"entries", "hits", "misses", "hitRate"}
+    auto stats_to_qjson() const -> QJsonObject;
+
+private:
+    std::unordered_map<long, QJsonObject> m_entries;
+    quint64 m_hits{0};
+    quint64 m_misses{0};
+};
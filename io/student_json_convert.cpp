@@ -0,0 +1,90 @@
+#include "io/student_json_convert.h"
+#include "struct/student_json_reader.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace {
+    // 少于这个数的批次不值得分发到线程池
+    constexpr std::size_t kParallelThreshold = 64;
+    // 每个线程分到几段；段数多一些，单个元素耗时不均时负载更平衡
+    constexpr int kRangesPerThread = 4;
+
+    struct Slot {
+        std::optional<Stu_withScore> student;
+        QString error;
+    };
+
+    void convert_one(const QByteArray& bytes, Slot& slot) {
+        // 规整的元素直接解码；其余（包括所有出错的元素）走 QJsonDocument，结果和错误信息与原来相同
+        slot.student = StudentJsonReader::parse(std::string_view(bytes.constData(), static_cast<std::size_t>(bytes.size())));
+        if (slot.student) return;
+
+        QJsonParseError parseError;
+        const QJsonDocument doc = QJsonDocument::fromJson(bytes, &parseError);
+        if (parseError.error != QJsonParseError::NoError) {
+            slot.error = "JSON 解析失败: " + parseError.errorString();
+            return;
+        }
+        if (!doc.isObject()) {
+            slot.error = "数组元素不是对象";
+            return;
+        }
+        try {
+            slot.student = stu_with_score_from_qjson(doc.object());
+        } catch (const std::exception& e) {
+            slot.error = QString("从JSON转换学生失败: %1").arg(e.what());
+        }
+    }
+}
+
+auto convert_student_elements(const std::vector<JsonElement>& elements, qint64 firstIndex, QThreadPool* pool)
+    -> StudentConversionResult {
+    std::vector<Slot> converted(elements.size());
+
+    const int threads = pool ? std::max(1, pool->maxThreadCount()) : 1;
+    if (elements.size() < kParallelThreshold || threads == 1) {
+        for (std::size_t i = 0; i < elements.size(); ++i) convert_one(elements[i].bytes, converted[i]);
+    } else {
+        const std::size_t parts = std::min(elements.size(), static_cast<std::size_t>(threads) * kRangesPerThread);
+        std::vector<std::pair<std::size_t, std::size_t>> ranges;
+        ranges.reserve(parts);
+        for (std::size_t p = 0; p < parts; ++p) {
+            ranges.emplace_back(elements.size() * p / parts, elements.size() * (p + 1) / parts);
+        }
+        QtConcurrent::blockingMap(pool, ranges, [&] (const std::pair<std::size_t, std::size_t>& range) {
+            for (std::size_t i = range.first; i < range.second; ++i) convert_one(elements[i].bytes, converted[i]);
+        });
+    }
+
+    StudentConversionResult result;
+    result.students.reserve(converted.size());
+    for (std::size_t i = 0; i < converted.size(); ++i) {
+        if (converted[i].student) {
+            result.students.push_back(std::move(*converted[i].student));
+        } else {
+            result.errors.push_back({firstIndex + static_cast<qint64>(i), elements[i].offset, converted[i].error});
+        }
+    }
+    return result;
+}
+
+auto conversion_errors_to_qjson(const std::vector<StudentConversionError>& errors, std::size_t limit) -> QJsonArray {
+    QJsonArray arr;
+    for (std::size_t i = 0; i < errors.size() && i < limit; ++i) {
+        QJsonObject obj;
+        obj["index"]   = errors[i].index;
+        obj["offset"]  = errors[i].offset;
+        obj["message"] = errors[i].message;
+        arr.append(obj);
+    }
+    return arr;
+}
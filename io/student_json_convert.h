@@ -0,0 +1,43 @@
+#pragma once
+
+#include "struct/stu_with_score.h"
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QString>
+#include <QThreadPool>
+
+#include <cstddef>
+#include <vector>
+
+// 导入时把 JsonArrayStreamReader 读出的一批原始元素解析并转换成 Stu_withScore。
+// 每个元素先交给 StudentJsonReader 直接解码，它不处理的元素再走
+// QJsonDocument::fromJson + stu_with_score_from_qjson。两者都是纯计算，批内按下标分段
+// 交给线程池并行执行；每个元素的结果写到自己的位置，合并时按原顺序取出，
+// 所以输出顺序与文件顺序一致，与线程数无关。
+//
+// 单个元素的错误（不是合法 JSON、不是对象、字段转换抛异常）不打断整批，
+// 收集到 errors 里由调用方汇总报告。
+
+struct JsonElement {
+    QByteArray bytes;
+    qint64 offset{0}; // 元素结束处在文件中的字节偏移
+};
+
+struct StudentConversionError {
+    qint64 index{0}; // 在顶层数组中的下标
+    qint64 offset{0};
+    QString message;
+};
+
+struct StudentConversionResult {
+    std::vector<Stu_withScore> students; // 与成功的元素一一对应，保持原顺序
+    std::vector<StudentConversionError> errors;
+};
+
+// elements[i] 是数组中第 firstIndex + i 个元素。元素较少时直接在调用线程上转换
+auto convert_student_elements(const std::vector<JsonElement>& elements, qint64 firstIndex,
+                              QThreadPool* pool = QThreadPool::globalInstance()) -> StudentConversionResult;
+
+// 最多取前 limit 条：[{"index", "offset", "message"}]
+auto conversion_errors_to_qjson(const std::vector<StudentConversionError>& errors, std::size_t limit) -> QJsonArray;
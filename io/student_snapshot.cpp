@@ -0,0 +1,331 @@
+#include "io/student_snapshot.h"
+
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace {
+    constexpr char kMagic[8]         = {'S', 'T', 'U', 'S', 'N', 'A', 'P', '\0'};
+    constexpr quint32 kByteOrderMark = 0x01020304;
+
+    struct StrRef {
+        quint32 offset;
+        quint32 size;
+    };
+
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 byteOrder;
+        quint64 checksum; // 覆盖 checksum 之后直到文件末尾的所有字节
+        quint32 headerSize;
+        quint32 studentRecordSize;
+        quint32 familyRecordSize;
+        quint32 scoreRecordSize;
+        qint64 revision;
+        char dbId[32]; // 不足 32 字节时补 0
+        quint64 studentCount;
+        quint64 familyCount;
+        quint64 scoreCount;
+        quint64 heapSize;
+    };
+
+    struct StudentRecord {
+        qint64 id;
+        qint32 sex;
+        qint32 status;
+        qint32 birthYear;
+        qint32 birthMonth;
+        qint32 birthDay;
+        qint32 enrollYear;
+        qint32 classId;
+        quint32 familyCount;
+        quint32 scoreCount;
+        quint32 reserved;
+        StrRef name;
+        StrRef major;
+        StrRef phone;
+        StrRef email;
+        StrRef province;
+        StrRef city;
+    };
+
+    struct FamilyRecord {
+        StrRef name;
+        StrRef relationship;
+        StrRef phone;
+        StrRef email;
+    };
+
+    struct ScoreRecord {
+        StrRef course;
+        double score;
+        double gpa;
+    };
+
+    // 各段首尾相接，定长记录都是 8 的倍数才能保证后面的段仍然对齐
+    static_assert(sizeof(Header) % 8 == 0 && sizeof(StudentRecord) % 8 == 0 && sizeof(FamilyRecord) % 8 == 0
+                  && sizeof(ScoreRecord) % 8 == 0);
+    static_assert(std::is_trivially_copyable_v<Header> && std::is_trivially_copyable_v<StudentRecord>
+                  && std::is_trivially_copyable_v<FamilyRecord> && std::is_trivially_copyable_v<ScoreRecord>);
+
+    constexpr std::size_t kChecksumEnd = offsetof(Header, checksum) + sizeof(quint64);
+
+    // 按 8 字节一组混合。不是加密哈希，只用来发现截断、损坏和写了一半的文件
+    auto checksum(const uchar* data, std::size_t size) -> quint64 {
+        quint64 h     = 0x9e3779b97f4a7c15ULL ^ size;
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            quint64 word;
+            std::memcpy(&word, data + i, 8);
+            h = (h ^ word) * 0xff51afd7ed558ccdULL;
+            h ^= h >> 29;
+        }
+        quint64 tail = 0;
+        std::memcpy(&tail, data + i, size - i);
+        h = (h ^ tail) * 0xc4ceb9fe1a85ec53ULL;
+        return h ^ (h >> 32);
+    }
+
+    // 相同的专业、省市、课程名等只存一份
+    class StringHeap {
+    public:
+        auto add(const std::string& s) -> StrRef {
+            auto [it, inserted] = m_offsets.try_emplace(s, static_cast<quint32>(m_bytes.size()));
+            if (inserted) m_bytes.append(s.data(), static_cast<qsizetype>(s.size()));
+            return {it->second, static_cast<quint32>(s.size())};
+        }
+
+        auto bytes() const -> const QByteArray& { return m_bytes; }
+
+    private:
+        QByteArray m_bytes;
+        std::unordered_map<std::string, quint32> m_offsets;
+    };
+
+    template<typename T>
+    void append_records(QByteArray& out, const std::vector<T>& records) {
+        out.append(reinterpret_cast<const char*>(records.data()), static_cast<qsizetype>(records.size() * sizeof(T)));
+    }
+
+    template<typename T>
+    auto record_at(const uchar* base, std::size_t index) -> T {
+        T record;
+        std::memcpy(&record, base + index * sizeof(T), sizeof(T));
+        return record;
+    }
+
+    // 越界的字符串引用说明文件已损坏，置 ok = false
+    class HeapView {
+    public:
+        HeapView(const char* data, quint64 size) : m_data(data), m_size(size) {}
+
+        auto text(StrRef ref, bool& ok) const -> std::string {
+            if (static_cast<quint64>(ref.offset) + ref.size > m_size) {
+                ok = false;
+                return {};
+            }
+            return std::string(m_data + ref.offset, ref.size);
+        }
+
+    private:
+        const char* m_data;
+        quint64 m_size;
+    };
+
+    auto snapshot_result(bool success, const QString& message) -> QJsonObject {
+        QJsonObject result;
+        result["success"] = success;
+        if (!message.isEmpty()) result["message"] = message;
+        return result;
+    }
+}
+
+auto write_student_snapshot(const QString& path, const StudentStore& store, const QString& dbId, qint64 revision)
+    -> QJsonObject {
+    std::vector<StudentRecord> students;
+    std::vector<FamilyRecord> family;
+    std::vector<ScoreRecord> scores;
+    students.reserve(store.size());
+    family.reserve(store.size());
+    scores.reserve(store.size() * 4);
+    StringHeap heap;
+
+    store.for_each([&] (const Stu_withScore& student) {
+        StudentRecord record{};
+        record.id          = student.get_id();
+        record.sex         = static_cast<qint32>(student.get_sex());
+        record.status      = static_cast<qint32>(student.get_status());
+        record.birthYear   = student.get_birthdate().year;
+        record.birthMonth  = student.get_birthdate().month;
+        record.birthDay    = student.get_birthdate().day;
+        record.enrollYear  = student.get_enroll_year();
+        record.classId     = student.get_class();
+        record.familyCount = static_cast<quint32>(student.get_family_members().size());
+        record.scoreCount  = static_cast<quint32>(student.get_all_scores().size());
+        record.name        = heap.add(student.get_name());
+        record.major       = heap.add(student.get_major());
+        record.phone       = heap.add(student.get_contact().phone);
+        record.email       = heap.add(student.get_contact().email);
+        record.province    = heap.add(student.get_address().province);
+        record.city        = heap.add(student.get_address().city);
+        students.push_back(record);
+
+        for (const FamilyMember& member : student.get_family_members()) {
+            family.push_back({heap.add(member.name), heap.add(member.relationship),
+                              heap.add(member.contactInfo.phone), heap.add(member.contactInfo.email)});
+        }
+        for (const auto& [course, score] : student.get_all_scores()) {
+            scores.push_back({heap.add(course), score.score, score.gpa});
+        }
+    });
+    if (static_cast<quint64>(heap.bytes().size()) > std::numeric_limits<quint32>::max()) {
+        return snapshot_result(false, "字符串数据超过快照格式上限");
+    }
+
+    const QByteArray id = dbId.toLatin1();
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version           = kStudentSnapshotVersion;
+    header.byteOrder         = kByteOrderMark;
+    header.headerSize        = sizeof(Header);
+    header.studentRecordSize = sizeof(StudentRecord);
+    header.familyRecordSize  = sizeof(FamilyRecord);
+    header.scoreRecordSize   = sizeof(ScoreRecord);
+    header.revision          = revision;
+    std::memcpy(header.dbId, id.constData(), std::min<std::size_t>(static_cast<std::size_t>(id.size()), sizeof(header.dbId)));
+    header.studentCount = students.size();
+    header.familyCount  = family.size();
+    header.scoreCount   = scores.size();
+    header.heapSize     = static_cast<quint64>(heap.bytes().size());
+
+    QByteArray bytes;
+    bytes.reserve(static_cast<qsizetype>(sizeof(Header) + students.size() * sizeof(StudentRecord)
+                                         + family.size() * sizeof(FamilyRecord) + scores.size() * sizeof(ScoreRecord))
+                  + heap.bytes().size());
+    bytes.append(reinterpret_cast<const char*>(&header), sizeof(Header));
+    append_records(bytes, students);
+    append_records(bytes, family);
+    append_records(bytes, scores);
+    bytes.append(heap.bytes());
+
+    header.checksum = checksum(reinterpret_cast<const uchar*>(bytes.constData()) + kChecksumEnd,
+                               static_cast<std::size_t>(bytes.size()) - kChecksumEnd);
+    std::memcpy(bytes.data() + offsetof(Header, checksum), &header.checksum, sizeof(header.checksum));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return snapshot_result(false, "无法写入快照: " + file.errorString());
+    }
+    if (file.write(bytes) != bytes.size() || !file.commit()) {
+        file.cancelWriting();
+        return snapshot_result(false, "写入快照失败: " + file.errorString());
+    }
+    QJsonObject result = snapshot_result(true, QString());
+    result["count"]    = static_cast<qint64>(students.size());
+    result["bytes"]    = static_cast<qint64>(bytes.size());
+    return result;
+}
+
+auto read_student_snapshot(const QString& path, const QString& dbId, qint64 revision, std::vector<Stu_withScore>& out)
+    -> QJsonObject {
+    QFile file(path);
+    if (!file.exists()) return snapshot_result(false, "快照不存在");
+    if (!file.open(QIODevice::ReadOnly)) return snapshot_result(false, "无法打开快照: " + file.errorString());
+
+    const qint64 fileSize = file.size();
+    if (fileSize < static_cast<qint64>(sizeof(Header))) return snapshot_result(false, "快照文件不完整");
+    // 映射在 file 关闭或析构时自动解除
+    const uchar* data = file.map(0, fileSize);
+    if (!data) return snapshot_result(false, "映射快照失败: " + file.errorString());
+    const auto size = static_cast<quint64>(fileSize);
+
+    const auto header = record_at<Header>(data, 0);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kStudentSnapshotVersion
+        || header.byteOrder != kByteOrderMark || header.headerSize != sizeof(Header)
+        || header.studentRecordSize != sizeof(StudentRecord) || header.familyRecordSize != sizeof(FamilyRecord)
+        || header.scoreRecordSize != sizeof(ScoreRecord)) {
+        return snapshot_result(false, "快照格式不兼容");
+    }
+    const char* idEnd = std::find(header.dbId, header.dbId + sizeof(header.dbId), '\0');
+    const QByteArray id(header.dbId, static_cast<qsizetype>(idEnd - header.dbId));
+    if (header.revision != revision || id != dbId.toLatin1()) {
+        return snapshot_result(false, QString("快照已过期 (快照版本 %1，数据库版本 %2)").arg(header.revision).arg(revision));
+    }
+
+    // 先分别和文件大小比较，避免条数损坏时乘法溢出
+    if (header.studentCount > size / sizeof(StudentRecord) || header.familyCount > size / sizeof(FamilyRecord)
+        || header.scoreCount > size / sizeof(ScoreRecord) || header.heapSize > size
+        || sizeof(Header) + header.studentCount * sizeof(StudentRecord) + header.familyCount * sizeof(FamilyRecord)
+                   + header.scoreCount * sizeof(ScoreRecord) + header.heapSize != size) {
+        return snapshot_result(false, "快照文件大小与头部不符");
+    }
+    if (checksum(data + kChecksumEnd, static_cast<std::size_t>(size) - kChecksumEnd) != header.checksum) {
+        return snapshot_result(false, "快照校验和不符");
+    }
+
+    const uchar* studentBase = data + sizeof(Header);
+    const uchar* familyBase  = studentBase + header.studentCount * sizeof(StudentRecord);
+    const uchar* scoreBase   = familyBase + header.familyCount * sizeof(FamilyRecord);
+    const HeapView heap(reinterpret_cast<const char*>(scoreBase + header.scoreCount * sizeof(ScoreRecord)),
+                        header.heapSize);
+
+    std::vector<Stu_withScore> students;
+    students.reserve(static_cast<std::size_t>(header.studentCount));
+    quint64 nextFamily = 0;
+    quint64 nextScore  = 0;
+    bool ok            = true;
+    // 堆中相同的课程名只存一份，按 (偏移, 长度) 缓存对应的 CourseId，每门课只查一次名表
+    std::unordered_map<quint64, CourseId> courseIds;
+    for (quint64 i = 0; i < header.studentCount && ok; ++i) {
+        const auto record = record_at<StudentRecord>(studentBase, static_cast<std::size_t>(i));
+        if (record.familyCount > header.familyCount - nextFamily || record.scoreCount > header.scoreCount - nextScore) {
+            ok = false;
+            break;
+        }
+
+        Stu_withScore& student = students.emplace_back();
+        student.set_id(static_cast<long>(record.id));
+        student.set_name(heap.text(record.name, ok));
+        student.set_sex(static_cast<Sex>(record.sex));
+        student.set_status(static_cast<Status>(record.status));
+        student.set_birthdate({record.birthYear, record.birthMonth, record.birthDay});
+        student.set_enroll_year(record.enrollYear);
+        student.set_major(heap.text(record.major, ok));
+        student.set_class(record.classId);
+        student.set_contact({heap.text(record.phone, ok), heap.text(record.email, ok)});
+        student.set_address({heap.text(record.province, ok), heap.text(record.city, ok)});
+        student.reserve_scores(record.scoreCount);
+
+        for (quint32 f = 0; f < record.familyCount; ++f) {
+            const auto member = record_at<FamilyRecord>(familyBase, static_cast<std::size_t>(nextFamily++));
+            student.add_family_member({heap.text(member.name, ok), heap.text(member.relationship, ok),
+                                       {heap.text(member.phone, ok), heap.text(member.email, ok)}});
+        }
+        for (quint32 s = 0; s < record.scoreCount; ++s) {
+            const auto score = record_at<ScoreRecord>(scoreBase, static_cast<std::size_t>(nextScore++));
+            const quint64 key = (static_cast<quint64>(score.course.offset) << 32) | score.course.size;
+            auto course       = courseIds.find(key);
+            if (course == courseIds.end()) {
+                course = courseIds.emplace(key, intern_course(heap.text(score.course, ok))).first;
+            }
+            student.add_score(course->second, Score(score.score, score.gpa));
+        }
+    }
+    if (!ok || nextFamily != header.familyCount || nextScore != header.scoreCount) {
+        return snapshot_result(false, "快照内容损坏");
+    }
+
+    out = std::move(students);
+    QJsonObject result = snapshot_result(true, QString());
+    result["count"]    = static_cast<qint64>(out.size());
+    result["bytes"]    = fileSize;
+    return result;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "struct/student_store.h"
+
+#include <QJsonObject>
+#include <QString>
+
+#include <vector>
+
+// 内存学生库的二进制快照，启动时代替逐行查询 SQLite。
+//
+// 文件布局（本机字节序，各段按 8 字节对齐）：
+//   Header | StudentRecord[students] | FamilyRecord[family] | ScoreRecord[scores] | 字符串堆
+// 记录定长，字符串以 (偏移, 长度) 指向堆中的 UTF-8 字节，相同字符串只存一份。
+// 家庭成员和成绩按学生顺序连续存放，条数记在学生记录里。
+//
+// 头部带格式版本、字节序标记和整个文件（除校验和字段外）的 64 位校验和，
+// 以及写出时数据库的 dbId / revision（见 read_data_revision）。
+// 读取时 mmap 文件并逐项校验，任何一项不符都视为快照不可用，由调用方回退到数据库。
+inline constexpr quint32 kStudentSnapshotVersion = 1;
+
+// 原子替换 path（QSaveFile）。返回 {"success", "message", "count", "bytes"}
+auto write_student_snapshot(const QString& path, const StudentStore& store, const QString& dbId, qint64 revision)
+    -> QJsonObject;
+
+// 只有快照与 dbId / revision 完全一致时才成功并填充 out；
+// 返回 {"success", "message": 不可用的原因, "count", "bytes"}
+auto read_student_snapshot(const QString& path, const QString& dbId, qint64 revision, std::vector<Stu_withScore>& out)
+    -> QJsonObject;
@@ -1,10 +1,12 @@
 #include "mainwindow.h"
+#include "struct/startup_timeline.h"
 
 #include <QApplication>
 #include <QStyleFactory>
 
 int main(int argc, char *argv[])
 {
+    StartupTimeline::instance().mark("process_start");
     QApplication app(argc, argv);
     
     app.setApplicationName("Qt Web学生管理系统");
@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "struct/startup_timeline.h"
 
 #include <QApplication>
 #include <QFileDialog>
@@ -96,9 +97,12 @@ void MainWindow::setup_web_view() {
     connect(m_webBridge, &WebBridge::page_requested, this, &MainWindow::on_page_requested);
     // 加载HTML文件
     m_webView->load(QUrl("qrc:/web/vue-proj/dist/index.html"));
+    // 页面开始加载后再打开数据库，两者在不同线程上同时进行
+    m_webBridge->start();
 }
 
 void MainWindow::on_load_started() {
+    StartupTimeline::instance().mark("page_load_started");
     m_progressBar->setVisible(true);
     m_statusLabel->setText("正在加载...");
 }
@@ -112,6 +116,7 @@ void MainWindow::on_load_finished(bool success) {
 
     if (success) {
         m_statusLabel->setText("加载完成");
+        m_webBridge->notify_page_loaded();
     } else {
         m_statusLabel->setText("加载失败");
         QMessageBox::warning(this, "错误", "无法加载Web页面，请检查web目录下的HTML文件是否存在。");
@@ -151,6 +151,9 @@ try:
             except Exception as e:
                 print(f"Skipping record due to an error: {e}. Record: {student}")
 
+        # Invalidate the app's startup snapshot (the table only exists once the app has upgraded the database)
+        if cursor.execute("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'data_revision'").fetchone():
+            cursor.execute("UPDATE data_revision SET revision = revision + 1 WHERE id = 1")
         db.commit()
         print(f"Successfully inserted or updated {insert_count} student records.")
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -- versioned change feed for the student store --
+// 每次修改（单条增删改或一次完整导入）生成一批变更并把 revision 加一。
+// 客户端记住自己看到的 revision，错过信号时用 since() 追上；
+// 历史超过容量或遇到 reset 批次后，更早的 revision 只能整体重新加载。
+
+struct StudentChangeSet {
+    std::uint64_t revision{}; // 应用这批变更之后的版本
+    bool reset{false};        // 需要整体重新加载
+    std::vector<long> added{};
+    std::vector<long> updated{};
+    std::vector<long> removed{};
+
+    bool empty() const { return !reset && added.empty() && updated.empty() && removed.empty(); }
+
+    auto id_count() const -> std::size_t { return added.size() + updated.size() + removed.size(); }
+};
+
+class StudentChangeLog {
+    std::deque<StudentChangeSet> batches;
+    std::uint64_t current{0};
+    std::uint64_t floor{0}; // 早于它的 revision 无法增量追上
+    std::size_t retainedIds{0};
+    std::size_t maxRetainedIds;
+
+public:
+    explicit StudentChangeLog(std::size_t maxRetainedIds = 100000) : maxRetainedIds(maxRetainedIds) {}
+
+    auto revision() const -> std::uint64_t { return current; }
+
+    // 分配 revision 并保存；返回保存后的批次
+    auto append(StudentChangeSet set) -> const StudentChangeSet& {
+        set.revision = ++current;
+        if (set.reset) {
+            batches.clear();
+            retainedIds = 0;
+            floor       = set.revision;
+        }
+        retainedIds += set.id_count();
+        batches.push_back(std::move(set));
+        while (retainedIds > maxRetainedIds && batches.size() > 1) {
+            retainedIds -= batches.front().id_count();
+            batches.pop_front();
+            floor = batches.front().revision - 1;
+        }
+        return batches.back();
+    }
+
+    // 合并 revision 之后的所有批次：先增后删的学号互相抵消，
+    // 先删后增的记为修改
+    auto since(std::uint64_t rev) const -> StudentChangeSet {
+        StudentChangeSet out;
+        out.revision = current;
+        if (rev >= current) return out;
+        if (rev < floor) {
+            out.reset = true;
+            return out;
+        }
+
+        enum class Net { Added, Updated, Removed, None };
+        std::unordered_map<long, Net> net;
+        std::vector<long> order; // 首次出现的顺序，保证输出稳定
+        auto touch = [&] (long id) -> Net& {
+            auto [it, inserted] = net.try_emplace(id, Net::None);
+            if (inserted) order.push_back(id);
+            return it->second;
+        };
+
+        for (const auto& b : batches) {
+            if (b.revision <= rev) continue;
+            for (long id : b.added) {
+                Net& n = touch(id);
+                n      = n == Net::Removed ? Net::Updated : Net::Added;
+            }
+            for (long id : b.updated) {
+                Net& n = touch(id);
+                if (n != Net::Added) n = Net::Updated;
+            }
+            for (long id : b.removed) {
+                Net& n = touch(id);
+                n      = n == Net::Added ? Net::None : Net::Removed;
+            }
+        }
+
+        for (long id : order) {
+            switch (net[id]) {
+                case Net::Added: out.added.push_back(id);
+                    break;
+                case Net::Updated: out.updated.push_back(id);
+                    break;
+                case Net::Removed: out.removed.push_back(id);
+                    break;
+                case Net::None: break;
+            }
+        }
+        return out;
+    }
+};
+
+// -- JSON conversions for StudentChangeSet --
+#ifdef USE_QTJSON
+#include <QJsonArray>
+#include <QJsonObject>
+
+inline auto student_change_set_to_qjson(const StudentChangeSet& set) -> QJsonObject {
+    auto ids_to_qjson = [] (const std::vector<long>& ids) {
+        QJsonArray arr;
+        for (long id : ids) arr.append(static_cast<qint64>(id));
+        return arr;
+    };
+    QJsonObject obj;
+    obj["revision"] = static_cast<qint64>(set.revision);
+    obj["reset"]    = set.reset;
+    obj["added"]    = ids_to_qjson(set.added);
+    obj["updated"]  = ids_to_qjson(set.updated);
+    obj["removed"]  = ids_to_qjson(set.removed);
+    return obj;
+}
+
+#endif // USE_QTJSON
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "json_writer.h"
+
 #include <string>
 #include <vector>
 
@@ -72,6 +74,51 @@ public:
     }
 };
 
+// -- direct JSON output (JsonWriter), same fields as course_to_qjson --
+
+inline auto day_of_week_json_name(DayOfWeek d) -> const char* {
+    switch (d) {
+        case DayOfWeek::Tuesday: return "Tuesday";
+        case DayOfWeek::Wednesday: return "Wednesday";
+        case DayOfWeek::Thursday: return "Thursday";
+        case DayOfWeek::Friday: return "Friday";
+        case DayOfWeek::Saturday: return "Saturday";
+        case DayOfWeek::Sunday: return "Sunday";
+        default: return "Monday";
+    }
+}
+
+inline auto repetition_json_name(Repetition r) -> const char* {
+    switch (r) {
+        case Repetition::BiWeeklyOdd: return "BiWeeklyOdd";
+        case Repetition::BiWeeklyEven: return "BiWeeklyEven";
+        default: return "Weekly";
+    }
+}
+
+inline void write_json(JsonWriter& w, const Time& t) {
+    w.begin_object().field("hour", t.hour).field("minute", t.minute).end_object();
+}
+
+inline void write_json(JsonWriter& w, const TimeSlot& ts) {
+    w.begin_object().field("day", day_of_week_json_name(ts.day));
+    write_json(w.key("startTime"), ts.startTime);
+    write_json(w.key("endTime"), ts.endTime);
+    w.field("repetition", repetition_json_name(ts.repetition)).end_object();
+}
+
+inline void write_json(JsonWriter& w, const Course& c) {
+    w.begin_object()
+        .field("courseID", c.get_course_id())
+        .field("courseName", c.get_course_name())
+        .field("instructor", c.get_instructor())
+        .field("location", c.get_location())
+        .field("credits", c.get_credits());
+    w.key("schedule").begin_array();
+    for (const auto& ts : c.get_schedule()) write_json(w, ts);
+    w.end_array().end_object();
+}
+
 #ifdef USE_QTJSON
 
 #include <QJsonArray>
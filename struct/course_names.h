@@ -0,0 +1,24 @@
+#pragma once
+
+#include "string_pool.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// -- course name interning --
+// 进程内唯一的课程名表：每个课程名只存一份，成绩里只记 4 字节的 CourseId。
+
+using CourseId = std::uint32_t;
+
+class CourseNames {
+public:
+    static auto instance() -> StringPool& {
+        static StringPool names;
+        return names;
+    }
+};
+
+inline auto intern_course(std::string_view name) -> CourseId { return CourseNames::instance().intern(name); }
+
+inline auto course_name(CourseId id) -> const std::string& { return CourseNames::instance().name(id); }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+// -- 8-byte-at-a-time JSON byte classification --
+// 把 8 个字节读成一个 64 位字，用位运算同时判断每个字节，
+// JsonWriter 的转义和 StudentJsonReader 的字符串扫描都用它跳过普通字符。
+// 结果只用来判断“这 8 个字节里有没有”，可能多报（借位影响高位字节），不会漏报；
+// 报告“有”时由调用方逐字节确认。
+
+inline constexpr std::uint64_t kJsonOnes = 0x0101010101010101ull;
+inline constexpr std::uint64_t kJsonHigh = 0x8080808080808080ull;
+
+inline auto json_load8(const char* p) -> std::uint64_t {
+    std::uint64_t x;
+    std::memcpy(&x, p, 8);
+    return x;
+}
+
+inline auto json_has_zero_byte(std::uint64_t v) -> bool { return ((v - kJsonOnes) & ~v & kJsonHigh) != 0; }
+
+inline auto json_has_byte(std::uint64_t v, unsigned char c) -> bool { return json_has_zero_byte(v ^ (kJsonOnes * c)); }
+
+// 有小于 0x20 的控制字符
+inline auto json_has_control(std::uint64_t v) -> bool { return ((v - kJsonOnes * 0x20) & ~v & kJsonHigh) != 0; }
+
+// 有非 ASCII 字节（UTF-8 多字节序列的一部分）
+inline auto json_has_non_ascii(std::uint64_t v) -> bool { return (v & kJsonHigh) != 0; }
+
+// 字符串中需要特殊处理的字节：引号、反斜杠、控制字符
+inline auto json_has_string_special(std::uint64_t v) -> bool {
+    return json_has_control(v) || json_has_byte(v, '"') || json_has_byte(v, '\\');
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "json_scan.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// -- direct compact JSON output --
+// 把对象直接写成紧凑的 UTF-8 JSON 文本，不经过 QJsonObject / QJsonArray 树，
+// 也不逐字段转换成 QString。输出写进一块自管理的可增长缓冲区，clear() 只清空内容、
+// 保留容量，连续序列化多个响应时不再重新分配。
+//
+// 逗号由写入器自动插入：key() 之后跟一个值，数组里直接写值即可。
+// 字符串按 UTF-8 原样写出，只转义引号、反斜杠和控制字符；非有限的浮点数写成 null。
+// 各类型的 write_json 重载写在各自的头文件里（student.h、stu_with_score.h、course.h、message.h）。
+
+class JsonWriter {
+    std::unique_ptr<char[]> buf;
+    std::size_t len{0};
+    std::size_t cap{0};
+    bool needComma{false};
+
+    // 每次写入前按最坏情况预留一次空间，之后直接写指针，不再逐字节检查容量
+    auto reserve_more(std::size_t n) -> char* {
+        if (len + n > cap) {
+            const std::size_t newCap = std::max({cap * 2, len + n, std::size_t{256}});
+            std::unique_ptr<char[]> grown(new char[newCap]);
+            if (len) std::memcpy(grown.get(), buf.get(), len);
+            buf = std::move(grown);
+            cap = newCap;
+        }
+        return buf.get() + len;
+    }
+
+    void put(std::string_view s) {
+        std::memcpy(reserve_more(s.size()), s.data(), s.size());
+        len += s.size();
+    }
+
+    void separator() {
+        if (needComma) put(",");
+    }
+
+    template<typename T>
+    void append_number(T v) {
+        char* out = reserve_more(32); // 足够放下任何 64 位整数和最短表示的 double
+        len += static_cast<std::size_t>(std::to_chars(out, out + 32, v).ptr - out);
+    }
+
+    // 需要转义的字节：控制字符、引号和反斜杠
+    static auto needs_escape(unsigned char c) -> bool {
+        static constexpr auto table = [] {
+            std::array<bool, 256> t{};
+            for (int i = 0; i < 0x20; ++i) t[i] = true;
+            t['"']  = true;
+            t['\\'] = true;
+            return t;
+        }();
+        return table[c];
+    }
+
+    void append_escaped(std::string_view s) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        char* out   = reserve_more(s.size() * 6 + 2); // 最坏情况每个字节都写成 \u00XX
+        char* start = out;
+        *out++      = '"';
+        std::size_t run = 0; // 还没写出的、不需要转义的一段的起点
+        for (std::size_t i = 0; i < s.size(); ++i) {
+            // 一次检查 8 个字节，整段都不需要转义时直接跳过
+            while (i + 8 <= s.size() && !json_has_string_special(json_load8(s.data() + i))) i += 8;
+            if (i >= s.size()) break;
+            const auto c = static_cast<unsigned char>(s[i]);
+            if (!needs_escape(c)) continue;
+            std::memcpy(out, s.data() + run, i - run);
+            out += i - run;
+            run = i + 1;
+            *out++ = '\\';
+            switch (c) {
+                case '"': *out++ = '"'; break;
+                case '\\': *out++ = '\\'; break;
+                case '\n': *out++ = 'n'; break;
+                case '\r': *out++ = 'r'; break;
+                case '\t': *out++ = 't'; break;
+                case '\b': *out++ = 'b'; break;
+                case '\f': *out++ = 'f'; break;
+                default:
+                    *out++ = 'u';
+                    *out++ = '0';
+                    *out++ = '0';
+                    *out++ = kHex[c >> 4];
+                    *out++ = kHex[c & 0xf];
+            }
+        }
+        std::memcpy(out, s.data() + run, s.size() - run);
+        out += s.size() - run;
+        *out++ = '"';
+        len += static_cast<std::size_t>(out - start);
+    }
+
+public:
+    JsonWriter() = default;
+    explicit JsonWriter(std::size_t reserve) { reserve_more(reserve); }
+
+    void clear() {
+        len       = 0;
+        needComma = false;
+    }
+
+    auto view() const -> std::string_view { return {buf.get(), len}; }
+    auto str() const -> std::string { return std::string(view()); }
+    auto data() const -> const char* { return buf.get(); }
+    auto size() const -> std::size_t { return len; }
+
+    auto begin_object() -> JsonWriter& {
+        separator();
+        put("{");
+        needComma = false;
+        return *this;
+    }
+
+    auto end_object() -> JsonWriter& {
+        put("}");
+        needComma = true;
+        return *this;
+    }
+
+    auto begin_array() -> JsonWriter& {
+        separator();
+        put("[");
+        needComma = false;
+        return *this;
+    }
+
+    auto end_array() -> JsonWriter& {
+        put("]");
+        needComma = true;
+        return *this;
+    }
+
+    auto key(std::string_view k) -> JsonWriter& {
+        separator();
+        append_escaped(k);
+        put(":");
+        needComma = false;
+        return *this;
+    }
+
+    auto value(std::string_view s) -> JsonWriter& {
+        separator();
+        append_escaped(s);
+        needComma = true;
+        return *this;
+    }
+
+    auto value(const char* s) -> JsonWriter& { return value(std::string_view(s)); }
+    auto value(const std::string& s) -> JsonWriter& { return value(std::string_view(s)); }
+
+    auto value(bool b) -> JsonWriter& {
+        separator();
+        put(b ? "true" : "false");
+        needComma = true;
+        return *this;
+    }
+
+    auto value(int v) -> JsonWriter& { return value(static_cast<long long>(v)); }
+    auto value(long v) -> JsonWriter& { return value(static_cast<long long>(v)); }
+
+    auto value(long long v) -> JsonWriter& {
+        separator();
+        append_number(v);
+        needComma = true;
+        return *this;
+    }
+
+    auto value(std::size_t v) -> JsonWriter& {
+        separator();
+        append_number(static_cast<unsigned long long>(v));
+        needComma = true;
+        return *this;
+    }
+
+    auto value(double v) -> JsonWriter& {
+        if (!std::isfinite(v)) return null();
+        separator();
+        // 整数值（成绩、GPA 常见）走整数格式化，比最短表示的浮点格式化快得多，结果相同
+        if (v == std::trunc(v) && std::fabs(v) < 1e15) {
+            append_number(static_cast<long long>(v));
+        } else {
+            append_number(v);
+        }
+        needComma = true;
+        return *this;
+    }
+
+    auto null() -> JsonWriter& {
+        separator();
+        put("null");
+        needComma = true;
+        return *this;
+    }
+
+    // 已经是合法 JSON 的片段，原样写入
+    auto raw(std::string_view json) -> JsonWriter& {
+        separator();
+        put(json);
+        needComma = true;
+        return *this;
+    }
+
+    template<typename T>
+    auto field(std::string_view k, const T& v) -> JsonWriter& {
+        key(k);
+        return value(v);
+    }
+};
@@ -0,0 +1,376 @@
+#pragma once
+
+#include "student_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -- columnar score analytics --
+// 成绩按课程分列存放：每门课一段连续的 double，外加每个成绩所属的学生行号。
+// 统计只顺序扫描 double 数组，累加拆成多路独立的累加器，编译器可以向量化；
+// 不按班级 / 专业过滤时不复制数据，百分位数在一份拷贝上用 nth_element 求。
+//
+// 增删都是 O(该学生的课程数)：删除时把列尾元素换到空位，
+// 每个学生行记录自己的成绩在各列中的位置，被换动的元素随之更新。
+
+struct ScoreStatsOptions {
+    std::optional<std::string> course; // 为空时统计所有课程
+    std::optional<int> classId;
+    std::optional<std::string> major;
+    double passMark{60.0};
+    double bucketWidth{10.0};
+    double maxScore{100.0}; // 直方图覆盖 [0, maxScore]，越界的成绩计入首尾桶
+};
+
+// 选项来自页面：maxScore 不是正数时按 100 处理，桶宽至少为 maxScore / kMaxScoreBuckets
+inline constexpr double kMaxScoreBuckets = 1000;
+
+struct ScoreStats {
+    std::string course;
+    std::size_t count{0};
+    double mean{0};
+    double stddev{0}; // 总体标准差
+    double min{0};
+    double max{0};
+    double p10{0};
+    double p25{0};
+    double median{0};
+    double p75{0};
+    double p90{0};
+    double passRate{0};                 // 0~1
+    std::vector<std::size_t> histogram; // [0, w), [w, 2w), ...，最后一桶包含 maxScore
+};
+
+// -- kernels --
+// 四路累加器打破循环依赖；浮点加法不满足结合律，编译器不会自己这样改写
+
+struct ScoreMoments {
+    double sum{0};
+    double min{0};
+    double max{0};
+};
+
+inline auto score_moments(const double* data, std::size_t n) -> ScoreMoments {
+    if (n == 0) return {};
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    double lo0 = data[0], lo1 = data[0], lo2 = data[0], lo3 = data[0];
+    double hi0 = data[0], hi1 = data[0], hi2 = data[0], hi3 = data[0];
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += data[i];
+        s1 += data[i + 1];
+        s2 += data[i + 2];
+        s3 += data[i + 3];
+        lo0 = std::min(lo0, data[i]);
+        lo1 = std::min(lo1, data[i + 1]);
+        lo2 = std::min(lo2, data[i + 2]);
+        lo3 = std::min(lo3, data[i + 3]);
+        hi0 = std::max(hi0, data[i]);
+        hi1 = std::max(hi1, data[i + 1]);
+        hi2 = std::max(hi2, data[i + 2]);
+        hi3 = std::max(hi3, data[i + 3]);
+    }
+    for (; i < n; ++i) {
+        s0 += data[i];
+        lo0 = std::min(lo0, data[i]);
+        hi0 = std::max(hi0, data[i]);
+    }
+    return {(s0 + s1) + (s2 + s3), std::min(std::min(lo0, lo1), std::min(lo2, lo3)),
+            std::max(std::max(hi0, hi1), std::max(hi2, hi3))};
+}
+
+// 第二遍求离差平方和，比 sum(x^2) - n*mean^2 数值上稳定
+inline auto score_squared_deviation(const double* data, std::size_t n, double mean) -> double {
+    double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const double d0 = data[i] - mean, d1 = data[i + 1] - mean;
+        const double d2 = data[i + 2] - mean, d3 = data[i + 3] - mean;
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+        s2 += d2 * d2;
+        s3 += d3 * d3;
+    }
+    for (; i < n; ++i) s0 += (data[i] - mean) * (data[i] - mean);
+    return (s0 + s1) + (s2 + s3);
+}
+
+inline auto count_at_least(const double* data, std::size_t n, double mark) -> std::size_t {
+    std::size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += data[i] >= mark;
+        c1 += data[i + 1] >= mark;
+        c2 += data[i + 2] >= mark;
+        c3 += data[i + 3] >= mark;
+    }
+    for (; i < n; ++i) c0 += data[i] >= mark;
+    return (c0 + c1) + (c2 + c3);
+}
+
+// 先算出桶号再计数，两步分开；计数数组按路分开，避免相邻成绩落进同一桶时的写后读依赖
+inline void score_histogram(const double* data, std::size_t n, double width, std::vector<std::size_t>& buckets) {
+    const std::size_t count = buckets.size();
+    if (count == 0 || width <= 0) return;
+    const double last = static_cast<double>(count - 1);
+    std::vector<std::size_t> lanes(count * 4, 0);
+    std::size_t i = 0;
+    auto bucket_of = [&] (double x) {
+        return static_cast<std::size_t>(std::clamp(std::floor(x / width), 0.0, last));
+    };
+    for (; i + 4 <= n; i += 4) {
+        ++lanes[bucket_of(data[i])];
+        ++lanes[count + bucket_of(data[i + 1])];
+        ++lanes[2 * count + bucket_of(data[i + 2])];
+        ++lanes[3 * count + bucket_of(data[i + 3])];
+    }
+    for (; i < n; ++i) ++lanes[bucket_of(data[i])];
+    for (std::size_t b = 0; b < count; ++b) {
+        buckets[b] += lanes[b] + lanes[count + b] + lanes[2 * count + b] + lanes[3 * count + b];
+    }
+}
+
+// 线性插值百分位（与 numpy 默认一致）。ps 须升序；会重排 values
+inline auto score_percentiles(std::vector<double>& values, const std::vector<double>& ps) -> std::vector<double> {
+    std::vector<double> out(ps.size(), 0.0);
+    if (values.empty()) return out;
+    auto from = values.begin();
+    for (std::size_t k = 0; k < ps.size(); ++k) {
+        const double rank = ps[k] * static_cast<double>(values.size() - 1);
+        const auto lo     = static_cast<std::size_t>(std::floor(rank));
+        auto nth          = values.begin() + static_cast<std::ptrdiff_t>(lo);
+        // 前一次 nth_element 之后，左边的元素都不大于它，只需在右侧继续划分
+        if (nth >= from) std::nth_element(from, nth, values.end());
+        from = nth;
+        double value = *nth;
+        if (lo + 1 < values.size() && rank > static_cast<double>(lo)) {
+            const double next = *std::min_element(nth + 1, values.end());
+            value += (rank - static_cast<double>(lo)) * (next - value);
+        }
+        out[k] = value;
+    }
+    return out;
+}
+
+inline auto compute_score_stats(const double* data, std::size_t n, const ScoreStatsOptions& opt) -> ScoreStats {
+    ScoreStats stats;
+    stats.count = n;
+    // NaN 比较为假，同样落到默认值
+    const double maxScore = opt.maxScore > 0 && std::isfinite(opt.maxScore) ? opt.maxScore : 100.0;
+    const double width    = std::max(opt.bucketWidth > 0 ? opt.bucketWidth : 10.0, maxScore / kMaxScoreBuckets);
+    stats.histogram.assign(static_cast<std::size_t>(std::floor(maxScore / width)) + 1, 0);
+    // maxScore 正好是 width 的整数倍时，满分单独占一桶没有意义，并入最后一桶
+    if (stats.histogram.size() > 1 && std::fmod(maxScore, width) == 0) stats.histogram.pop_back();
+    if (n == 0) return stats;
+
+    const ScoreMoments m = score_moments(data, n);
+    stats.mean           = m.sum / static_cast<double>(n);
+    stats.min            = m.min;
+    stats.max            = m.max;
+    stats.stddev         = std::sqrt(score_squared_deviation(data, n, stats.mean) / static_cast<double>(n));
+    stats.passRate       = static_cast<double>(count_at_least(data, n, opt.passMark)) / static_cast<double>(n);
+    score_histogram(data, n, width, stats.histogram);
+
+    std::vector<double> scratch(data, data + n);
+    const auto p = score_percentiles(scratch, {0.10, 0.25, 0.50, 0.75, 0.90});
+    stats.p10    = p[0];
+    stats.p25    = p[1];
+    stats.median = p[2];
+    stats.p75    = p[3];
+    stats.p90    = p[4];
+    return stats;
+}
+
+class ScoreColumns {
+    struct Column {
+        std::string course;
+        std::vector<double> scores;
+        std::vector<std::uint32_t> rows; // 与 scores 对齐
+    };
+
+    struct Cell {
+        std::uint32_t column;
+        std::uint32_t position;
+    };
+
+    struct Row {
+        long id{};
+        int classId{};
+        std::uint32_t major{}; // Symbol id，与学生记录中的专业共用符号表
+        std::vector<Cell> cells;
+    };
+
+    std::vector<Column> columns;
+    std::unordered_map<CourseId, std::uint32_t> columnOf;
+    std::vector<Row> rows;
+    std::unordered_map<long, std::uint32_t> rowOf;
+
+    auto column_for(CourseId course) -> std::uint32_t {
+        auto [it, inserted] = columnOf.try_emplace(course, static_cast<std::uint32_t>(columns.size()));
+        if (inserted) columns.push_back({course_name(course), {}, {}});
+        return it->second;
+    }
+
+    // 把列尾换到 position，更新被换动元素所在行的记录
+    void remove_cell(std::uint32_t column, std::uint32_t position) {
+        Column& col               = columns[column];
+        const std::uint32_t last  = static_cast<std::uint32_t>(col.scores.size() - 1);
+        if (position != last) {
+            col.scores[position] = col.scores[last];
+            col.rows[position]   = col.rows[last];
+            for (Cell& cell : rows[col.rows[position]].cells) {
+                if (cell.column == column) {
+                    cell.position = position;
+                    break;
+                }
+            }
+        }
+        col.scores.pop_back();
+        col.rows.pop_back();
+    }
+
+public:
+    auto row_count() const -> std::size_t { return rows.size(); }
+    auto course_count() const -> std::size_t { return columns.size(); }
+
+    auto score_count() const -> std::size_t {
+        std::size_t n = 0;
+        for (const auto& col : columns) n += col.scores.size();
+        return n;
+    }
+
+    void clear() {
+        columns.clear();
+        columnOf.clear();
+        rows.clear();
+        rowOf.clear();
+    }
+
+    void rebuild(const StudentStore& store) {
+        clear();
+        rows.reserve(store.size());
+        rowOf.reserve(store.size());
+        store.for_each([&] (const Stu_withScore& student) { upsert(student); });
+    }
+
+    // 已存在的学生先整体移除再按新成绩加入
+    void upsert(const Stu_withScore& student) {
+        erase(student.get_id());
+        const auto row = static_cast<std::uint32_t>(rows.size());
+        rowOf[student.get_id()] = row;
+        Row& r    = rows.emplace_back();
+        r.id      = student.get_id();
+        r.classId = student.get_class();
+        r.major   = student.get_major_symbol().get_id();
+        r.cells.reserve(student.get_all_scores().size());
+        for (const auto& [course, score] : student.get_all_scores().raw()) {
+            const std::uint32_t column = column_for(course);
+            Column& col                = columns[column];
+            r.cells.push_back({column, static_cast<std::uint32_t>(col.scores.size())});
+            col.scores.push_back(score.score);
+            col.rows.push_back(row);
+        }
+    }
+
+    bool erase(long id) {
+        auto it = rowOf.find(id);
+        if (it == rowOf.end()) return false;
+        const std::uint32_t row = it->second;
+        rowOf.erase(it);
+        for (const Cell& cell : rows[row].cells) remove_cell(cell.column, cell.position);
+
+        // 行也按同样方式换尾删除，被换动的行在各列中的行号随之更新
+        const auto last = static_cast<std::uint32_t>(rows.size() - 1);
+        if (row != last) {
+            rows[row] = std::move(rows[last]);
+            rowOf[rows[row].id] = row;
+            for (const Cell& cell : rows[row].cells) columns[cell.column].rows[cell.position] = row;
+        }
+        rows.pop_back();
+        return true;
+    }
+
+    // 每门课一项，按课程名排序；没有成绩的课程（学生都被删掉后）不返回
+    auto stats(const ScoreStatsOptions& opt) const -> std::vector<ScoreStats> {
+        std::optional<std::uint32_t> major;
+        if (opt.major) {
+            // 只查找不登记；符号表里没有的专业不会有学生
+            const auto symbol = Symbol::find(*opt.major);
+            if (!symbol) return {};
+            major = symbol->get_id();
+        }
+        const bool filtered = opt.classId || major;
+
+        std::vector<ScoreStats> out;
+        std::vector<double> selected;
+        for (const Column& col : columns) {
+            if (opt.course && col.course != *opt.course) continue;
+            const double* data = col.scores.data();
+            std::size_t n      = col.scores.size();
+            if (filtered) {
+                selected.clear();
+                for (std::size_t i = 0; i < n; ++i) {
+                    const Row& r = rows[col.rows[i]];
+                    if (opt.classId && r.classId != *opt.classId) continue;
+                    if (major && r.major != *major) continue;
+                    selected.push_back(col.scores[i]);
+                }
+                data = selected.data();
+                n    = selected.size();
+            }
+            if (n == 0) continue;
+            ScoreStats s = compute_score_stats(data, n, opt);
+            s.course     = col.course;
+            out.push_back(std::move(s));
+        }
+        std::sort(out.begin(), out.end(), [] (const ScoreStats& a, const ScoreStats& b) { return a.course < b.course; });
+        return out;
+    }
+};
+
+// -- JSON conversions for score analytics --
+#ifdef USE_QTJSON
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+// {"course", "classId", "major", "passMark", "bucketWidth", "maxScore"}，都可省略
+inline auto score_stats_options_from_qjson(const QJsonObject& obj) -> ScoreStatsOptions {
+    ScoreStatsOptions opt;
+    if (obj.contains("course") && !obj["course"].toString().isEmpty()) opt.course = obj["course"].toString().toStdString();
+    if (obj.contains("classId") && !obj["classId"].isNull()) opt.classId = obj["classId"].toInt();
+    if (obj.contains("major") && !obj["major"].toString().isEmpty()) opt.major = obj["major"].toString().toStdString();
+    opt.passMark    = obj["passMark"].toDouble(opt.passMark);
+    opt.bucketWidth = obj["bucketWidth"].toDouble(opt.bucketWidth);
+    opt.maxScore    = obj["maxScore"].toDouble(opt.maxScore);
+    return opt;
+}
+
+inline auto score_stats_to_qjson(const ScoreStats& s) -> QJsonObject {
+    QJsonObject obj;
+    obj["course"]   = QString::fromStdString(s.course);
+    obj["count"]    = static_cast<qint64>(s.count);
+    obj["mean"]     = s.mean;
+    obj["stddev"]   = s.stddev;
+    obj["min"]      = s.min;
+    obj["max"]      = s.max;
+    obj["p10"]      = s.p10;
+    obj["p25"]      = s.p25;
+    obj["median"]   = s.median;
+    obj["p75"]      = s.p75;
+    obj["p90"]      = s.p90;
+    obj["passRate"] = s.passRate;
+    QJsonArray histogram;
+    for (std::size_t c : s.histogram) histogram.append(static_cast<qint64>(c));
+    obj["histogram"] = histogram;
+    return obj;
+}
+
+#endif // USE_QTJSON
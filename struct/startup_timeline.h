@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// -- startup milestones --
+// 进程内唯一的启动时间线。main() 一开始就 mark("process_start")，
+// 之后各阶段完成时各记一次，用来跟踪不同版本的启动耗时（time-to-interactive）。
+// 数据库线程上也会调用，内部加锁；同名里程碑只记第一次。
+
+struct StartupMilestone {
+    std::string name;
+    double sinceStartMs{};  // 距第一次使用时间线（即 process_start）的毫秒数
+    std::int64_t epochMs{}; // Unix 毫秒时间戳
+};
+
+class StartupTimeline {
+    mutable std::mutex mutex;
+    std::chrono::steady_clock::time_point origin{std::chrono::steady_clock::now()};
+    std::vector<StartupMilestone> milestones;
+
+    StartupTimeline() = default;
+
+public:
+    static auto instance() -> StartupTimeline& {
+        static StartupTimeline timeline;
+        return timeline;
+    }
+
+    // 已经记录过时返回 false
+    bool mark(const std::string& name) {
+        const auto now   = std::chrono::steady_clock::now();
+        const auto epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& m : milestones) {
+            if (m.name == name) return false;
+        }
+        milestones.push_back({name, std::chrono::duration<double, std::milli>(now - origin).count(),
+                              static_cast<std::int64_t>(epoch.count())});
+        return true;
+    }
+
+    bool has(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& m : milestones) {
+            if (m.name == name) return true;
+        }
+        return false;
+    }
+
+    // 按记录顺序
+    auto all() const -> std::vector<StartupMilestone> {
+        std::lock_guard<std::mutex> lock(mutex);
+        return milestones;
+    }
+};
+
+// -- JSON conversions for StartupTimeline --
+#ifdef USE_QTJSON
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+inline auto startup_timeline_to_qjson(const StartupTimeline& timeline) -> QJsonArray {
+    QJsonArray arr;
+    for (const auto& m : timeline.all()) {
+        QJsonObject obj;
+        obj["name"]         = QString::fromStdString(m.name);
+        obj["sinceStartMs"] = m.sinceStartMs;
+        obj["epochMs"]      = static_cast<qint64>(m.epochMs);
+        arr.append(obj);
+    }
+    return arr;
+}
+
+#endif // USE_QTJSON
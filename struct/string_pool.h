@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// -- string interning pool --
+// 每个不同的字符串只存一份，按第一次出现的顺序分配连续的 32 位 id，从不回收。
+// 课程名（CourseNames）和学生的专业、省市等重复字段（Symbol）各用一个池。
+//
+// 学生可能在数据库线程上构造，intern / find 内部加锁；
+// 字符串按块存放，地址不变，name() 不加锁——拿到 id 时字符串一定已经写好。
+
+class StringPool {
+    static constexpr std::size_t kChunkSize = 256;
+    static constexpr std::size_t kMaxChunks = 4096; // 最多约 100 万个不同的字符串
+
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string_view, std::uint32_t> ids; // 键指向 chunks 中的字符串
+    std::array<std::unique_ptr<std::string[]>, kMaxChunks> chunks;
+    std::size_t count{0};
+
+public:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    auto intern(std::string_view s) -> std::uint32_t {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = ids.find(s);
+            if (it != ids.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(s);
+        if (it != ids.end()) return it->second;
+        if (count == kChunkSize * kMaxChunks) throw std::length_error("字符串池已满");
+
+        auto& chunk = chunks[count / kChunkSize];
+        if (!chunk) chunk = std::make_unique<std::string[]>(kChunkSize);
+        std::string& stored = chunk[count % kChunkSize];
+        stored.assign(s);
+        const auto id = static_cast<std::uint32_t>(count++);
+        ids.emplace(stored, id);
+        return id;
+    }
+
+    // 只查不插入；没出现过的字符串返回空
+    auto find(std::string_view s) const -> std::optional<std::uint32_t> {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(s);
+        if (it == ids.end()) return std::nullopt;
+        return it->second;
+    }
+
+    auto name(std::uint32_t id) const -> const std::string& { return chunks[id / kChunkSize][id % kChunkSize]; }
+
+    // id 都小于 size()，可以直接用作计数数组的下标
+    auto size() const -> std::size_t {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        return count;
+    }
+};
@@ -1,8 +1,16 @@
 #pragma once
 
 #include "student.h"
+#include "course_names.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 struct Score {
     double score;
@@ -11,8 +19,105 @@ struct Score {
     Score(double s, double g) : score(s), gpa(g) {}
 };
 
+// 一名学生的全部成绩：按 CourseId 排序的连续数组，课程名由 CourseNames 统一保存。
+// 接口与原先的 std::map<std::string, Score> 一致（find / at / count / size / 范围 for，
+// 元素为 (课程名, 成绩)），但遍历顺序是课程名第一次出现的顺序，不再按名字排序。
+class CourseScores {
+public:
+    using Entry = std::pair<CourseId, Score>;
+
+    class const_iterator {
+        std::vector<Entry>::const_iterator it;
+
+    public:
+        using iterator_category = std::input_iterator_tag; // 解引用得到的是 (名字, 成绩) 引用对，不是真正的引用
+        using value_type        = std::pair<const std::string&, const Score&>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = value_type;
+
+        struct pointer {
+            value_type pair;
+            auto operator->() const -> const value_type* { return &pair; }
+        };
+
+        const_iterator() = default;
+        explicit const_iterator(std::vector<Entry>::const_iterator i) : it(i) {}
+
+        auto course_id() const -> CourseId { return it->first; }
+        auto operator*() const -> reference { return {course_name(it->first), it->second}; }
+        auto operator->() const -> pointer { return {**this}; }
+        auto operator++() -> const_iterator& {
+            ++it;
+            return *this;
+        }
+        auto operator++(int) -> const_iterator { return const_iterator(it++); }
+        auto operator-(const const_iterator& other) const -> difference_type { return it - other.it; }
+        bool operator==(const const_iterator& other) const { return it == other.it; }
+        bool operator!=(const const_iterator& other) const { return it != other.it; }
+    };
+
+private:
+    std::vector<Entry> entries;
+
+    auto lower_bound(CourseId id) -> std::vector<Entry>::iterator {
+        return std::lower_bound(entries.begin(), entries.end(), id,
+                                [] (const Entry& e, CourseId v) { return e.first < v; });
+    }
+
+    auto lower_bound(CourseId id) const -> std::vector<Entry>::const_iterator {
+        return std::lower_bound(entries.begin(), entries.end(), id,
+                                [] (const Entry& e, CourseId v) { return e.first < v; });
+    }
+
+public:
+    auto begin() const -> const_iterator { return const_iterator(entries.begin()); }
+    auto end() const -> const_iterator { return const_iterator(entries.end()); }
+    auto size() const -> std::size_t { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    // 按 CourseId 排序的原始数组，统计等热点路径直接用它，不查课程名
+    auto raw() const -> const std::vector<Entry>& { return entries; }
+
+    auto find(CourseId id) const -> const_iterator {
+        auto it = lower_bound(id);
+        return const_iterator(it != entries.end() && it->first == id ? it : entries.end());
+    }
+
+    // 课程名从没出现过时不会被加入名表
+    auto find(std::string_view course) const -> const_iterator {
+        const auto id = CourseNames::instance().find(course);
+        return id ? find(*id) : end();
+    }
+
+    auto count(std::string_view course) const -> std::size_t { return find(course) != end() ? 1 : 0; }
+
+    auto at(std::string_view course) const -> const Score& {
+        auto it = find(course);
+        if (it == end()) throw std::out_of_range("没有该课程的成绩");
+        return (*it).second;
+    }
+
+    void reserve(std::size_t n) { entries.reserve(n); }
+    void clear() { entries.clear(); }
+
+    void set(CourseId id, Score score) {
+        auto it = lower_bound(id);
+        if (it != entries.end() && it->first == id) {
+            it->second = score;
+        } else {
+            entries.insert(it, {id, score});
+        }
+    }
+
+    bool erase(CourseId id) {
+        auto it = lower_bound(id);
+        if (it == entries.end() || it->first != id) return false;
+        entries.erase(it);
+        return true;
+    }
+};
+
 class Stu_withScore : public Student {
-    std::map<std::string, Score> courseScore;
+    CourseScores courseScore;
 
 public:
     Stu_withScore() = default;
@@ -24,32 +129,72 @@ public:
         return it != courseScore.end() ? it->second.score : 0.0;
     }
 
-    auto get_all_scores() const -> const std::map<std::string, Score>& {
+    auto get_all_scores() const -> const CourseScores& {
         return courseScore;
     }
 
     void set_scores(const std::map<std::string, Score>& new_scores) {
-        courseScore = new_scores;
+        courseScore.clear();
+        courseScore.reserve(new_scores.size());
+        for (const auto& [course, score] : new_scores) {
+            courseScore.set(intern_course(course), score);
+        }
     }
 
     void add_score(const std::string& course, Score score) {
-        courseScore[course] = score;
+        courseScore.set(intern_course(course), score);
+    }
+
+    void add_score(CourseId course, Score score) {
+        courseScore.set(course, score);
     }
 
     void del_score(const std::string& course) {
-        courseScore.erase(course);
+        if (const auto id = CourseNames::instance().find(course)) courseScore.erase(*id);
+    }
+
+    void reserve_scores(std::size_t n) {
+        courseScore.reserve(n);
     }
 
     double calculate_average() const {
         if (courseScore.empty()) return 0.0;
         double sum = 0.0;
-        for (const auto& pair : courseScore) {
-            sum += pair.second.score;
+        for (const auto& entry : courseScore.raw()) {
+            sum += entry.second.score;
+        }
+        return sum / static_cast<double>(courseScore.size());
+    }
+
+    double calculate_gpa() const {
+        if (courseScore.empty()) return 0.0;
+        double sum = 0.0;
+        for (const auto& entry : courseScore.raw()) {
+            sum += entry.second.gpa;
         }
         return sum / static_cast<double>(courseScore.size());
     }
 };
 
+// -- direct JSON output (JsonWriter), same fields as stu_with_score_to_qjson --
+
+inline void write_json(JsonWriter& w, const Score& s) {
+    w.begin_object().field("score", s.score).field("gpa", s.gpa).end_object();
+}
+
+inline void write_json(JsonWriter& w, const CourseScores& cs) {
+    w.begin_object();
+    for (const auto& [course, score] : cs) write_json(w.key(course), score);
+    w.end_object();
+}
+
+inline void write_json(JsonWriter& w, const Stu_withScore& stu) {
+    w.begin_object();
+    write_student_fields(w, stu);
+    write_json(w.key("scores"), stu.get_all_scores());
+    w.end_object();
+}
+
 // -- JSON conversions for Stu_withScore --
 #ifdef USE_QTJSON
 #include <QJsonArray>
@@ -71,10 +216,10 @@ inline auto score_from_qjson(const QJsonObject& obj) -> Score {
     return s;
 }
 
-inline auto course_score_to_qjson(const std::map<std::string, Score>& cs) -> QJsonObject {
+inline auto course_score_to_qjson(const CourseScores& cs) -> QJsonObject {
     QJsonObject obj;
-    for (const auto& pair : cs) {
-        obj[QString::fromStdString(pair.first)] = score_to_qjson(pair.second);
+    for (const auto& [course, score] : cs) {
+        obj[QString::fromStdString(course)] = score_to_qjson(score);
     }
     return obj;
 }
@@ -99,11 +244,10 @@ inline auto stu_with_score_from_qjson(const QJsonObject& obj) -> Stu_withScore {
     static_cast<Student&>(stu) = baseStudent;
     if (obj.contains("scores")) {
         QJsonObject scoresObj = obj["scores"].toObject();
-        std::map<std::string, Score> scores;
+        stu.reserve_scores(static_cast<std::size_t>(scoresObj.size()));
         for (auto it = scoresObj.begin(); it != scoresObj.end(); ++it) {
-            scores[it.key().toStdString()] = score_from_qjson(it.value().toObject());
+            stu.add_score(it.key().toStdString(), score_from_qjson(it.value().toObject()));
         }
-        stu.set_scores(scores);
     }
     return stu;
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "json_writer.h"
+#include "symbol.h"
+
 #include <algorithm>
 #include <ctime>
 #include <ostream>
@@ -18,9 +21,10 @@ struct Date {
     Date(int y, int m, int d) : year(y), month(m), day(d) {}
 };
 
+// 省、市、专业和家庭成员关系取值很少，用 Symbol 共享同一份字符串
 struct Address {
-    std::string province;
-    std::string city;
+    Symbol province;
+    Symbol city;
 
     Address() = default;
 
@@ -40,7 +44,7 @@ struct Contact {
 
 struct FamilyMember {
     std::string name;
-    std::string relationship;
+    Symbol relationship;
     Contact contactInfo;
 
     FamilyMember() = default;
@@ -63,7 +67,7 @@ protected:
     Date birthdate;
     int age{};
     int enrollYear{};
-    std::string major;
+    Symbol major;
     int class_;
     Contact contactInfo;
     Address address;
@@ -124,7 +128,8 @@ public:
     auto get_enroll_year() const -> int { return enrollYear; }
     void set_enroll_year(int v) { enrollYear = v; }
 
-    auto get_major() const -> const std::string& { return major; }
+    auto get_major() const -> const std::string& { return major.str(); }
+    auto get_major_symbol() const -> Symbol { return major; }
     void set_major(const std::string& v) { major = v; }
 
     auto get_class() const -> int { return class_; }
@@ -190,6 +195,59 @@ public:
     }
 };
 
+// -- direct JSON output (JsonWriter), same fields as student_to_qjson --
+
+inline auto sex_json_name(Sex s) -> const char* {
+    return s == Sex::Male ? "Male" : "Female";
+}
+
+inline auto status_json_name(Status st) -> const char* {
+    switch (st) {
+        case Status::Leave: return "Leave";
+        case Status::Graduated: return "Graduated";
+        default: return "Active";
+    }
+}
+
+inline void write_json(JsonWriter& w, const Date& d) {
+    w.begin_object().field("year", d.year).field("month", d.month).field("day", d.day).end_object();
+}
+
+inline void write_json(JsonWriter& w, const Address& a) {
+    w.begin_object().field("province", a.province.str()).field("city", a.city.str()).end_object();
+}
+
+inline void write_json(JsonWriter& w, const Contact& c) {
+    w.begin_object().field("phone", c.phone).field("email", c.email).end_object();
+}
+
+inline void write_json(JsonWriter& w, const FamilyMember& fm) {
+    w.begin_object().field("name", fm.name).field("relationship", fm.relationship.str());
+    write_json(w.key("contactInfo"), fm.contactInfo);
+    w.end_object();
+}
+
+// 只写字段、不写外层花括号，Stu_withScore 在同一个对象里接着写 scores
+inline void write_student_fields(JsonWriter& w, const Student& stu) {
+    w.field("id", stu.get_id()).field("name", stu.get_name()).field("sex", sex_json_name(stu.get_sex()));
+    write_json(w.key("birthdate"), stu.get_birthdate());
+    w.field("enrollYear", stu.get_enroll_year())
+        .field("major", stu.get_major())
+        .field("class_id", stu.get_class());
+    write_json(w.key("contact"), stu.get_contact());
+    write_json(w.key("address"), stu.get_address());
+    w.field("status", status_json_name(stu.get_status()));
+    w.key("familyMembers").begin_array();
+    for (const auto& fm : stu.get_family_members()) write_json(w, fm);
+    w.end_array();
+}
+
+inline void write_json(JsonWriter& w, const Student& stu) {
+    w.begin_object();
+    write_student_fields(w, stu);
+    w.end_object();
+}
+
 // -- JSON conversions --
 #ifdef USE_QTJSON
 #include <QJsonArray>
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "stu_with_score.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -- per-record content hash --
+// 覆盖写入数据库的全部内容：students 表各列、家庭成员（按顺序）和成绩。
+// 两个学生内容相同则哈希相同；哈希不同说明这条记录需要重写。
+// Symbol 和 CourseId 直接按 id 参与计算，结果只在同一进程内可比，不要保存下来。
+
+inline void student_hash_combine(std::uint64_t& h, std::uint64_t v) {
+    // splitmix64 的终结步骤把 v 打散后再合并，相邻的整数不会只差几位
+    v += 0x9e3779b97f4a7c15ull;
+    v = (v ^ (v >> 30)) * 0xbf58476d1ce4e5b9ull;
+    v = (v ^ (v >> 27)) * 0x94d049bb133111ebull;
+    v ^= v >> 31;
+    h = (h ^ v) * 0x100000001b3ull + (h >> 29);
+}
+
+inline void student_hash_combine(std::uint64_t& h, std::string_view s) {
+    student_hash_combine(h, s.size());
+    student_hash_combine(h, std::hash<std::string_view>{}(s));
+}
+
+inline auto student_hash_bits(double d) -> std::uint64_t {
+    std::uint64_t bits;
+    std::memcpy(&bits, &d, sizeof bits);
+    return bits;
+}
+
+inline auto student_content_hash(const Stu_withScore& stu) -> std::uint64_t {
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_id()));
+    student_hash_combine(h, std::string_view(stu.get_name()));
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_sex()));
+    const Date& d = stu.get_birthdate();
+    student_hash_combine(h, static_cast<std::uint64_t>(static_cast<std::uint32_t>(d.year)) << 32
+                                | static_cast<std::uint32_t>(d.month) << 16 | static_cast<std::uint32_t>(d.day));
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_age()));
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_enroll_year()));
+    student_hash_combine(h, stu.get_major_symbol().get_id());
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_class()));
+    student_hash_combine(h, std::string_view(stu.get_contact().phone));
+    student_hash_combine(h, std::string_view(stu.get_contact().email));
+    student_hash_combine(h, stu.get_address().province.get_id());
+    student_hash_combine(h, stu.get_address().city.get_id());
+    student_hash_combine(h, static_cast<std::uint64_t>(stu.get_status()));
+    student_hash_combine(h, stu.get_family_members().size());
+    for (const auto& fm : stu.get_family_members()) {
+        student_hash_combine(h, std::string_view(fm.name));
+        student_hash_combine(h, fm.relationship.get_id());
+        student_hash_combine(h, std::string_view(fm.contactInfo.phone));
+        student_hash_combine(h, std::string_view(fm.contactInfo.email));
+    }
+    const auto& scores = stu.get_all_scores().raw(); // 按 CourseId 排序，与添加顺序无关
+    student_hash_combine(h, scores.size());
+    for (const auto& [course, score] : scores) {
+        student_hash_combine(h, course);
+        student_hash_combine(h, student_hash_bits(score.score));
+        student_hash_combine(h, student_hash_bits(score.gpa));
+    }
+    return h;
+}
+
+// -- merge import bookkeeping --
+// 合并导入时按学号把文件中的学生与导入开始时的内存快照（学号 -> 内容哈希）比较。
+// stage() 对文件中的每个学生调用一次，返回 true 表示需要写入：新学号，
+// 或内容与当前生效的版本不同。同一学号在文件中出现多次时以最后一次为准，
+// 与整表替换时的 INSERT OR REPLACE 一致。
+class StudentImportDiff {
+    struct Seen {
+        std::uint64_t hash; // 最后一次出现时的内容
+        bool written;       // 是否已经写入过
+    };
+
+    std::unordered_map<long, std::uint64_t> baseline; // 导入开始时内存中的学生
+    std::unordered_map<long, Seen> seen;              // 文件中出现过的学号
+    std::vector<long> added;                          // 按第一次写入的顺序
+    std::vector<long> updated;
+
+public:
+    StudentImportDiff() = default;
+    explicit StudentImportDiff(std::unordered_map<long, std::uint64_t> base) : baseline(std::move(base)) {}
+
+    auto stage(const Stu_withScore& stu) -> bool {
+        const long id            = stu.get_id();
+        const std::uint64_t hash = student_content_hash(stu);
+        auto [it, first]         = seen.try_emplace(id, Seen{hash, false});
+        const auto base          = baseline.find(id);
+        // 重复出现时，之前的版本要么与快照相同，要么已经写入，当前生效的都是它
+        const bool write = first ? base == baseline.end() || base->second != hash : it->second.hash != hash;
+        if (write && !it->second.written) {
+            it->second.written = true;
+            (base == baseline.end() ? added : updated).push_back(id);
+        }
+        it->second.hash = hash;
+        return write;
+    }
+
+    // 写入过的学号：新增的和原有的
+    auto added_ids() const -> const std::vector<long>& { return added; }
+    auto updated_ids() const -> const std::vector<long>& { return updated; }
+
+    // 快照中有、文件中没有的学号，升序
+    auto missing_ids() const -> std::vector<long> {
+        std::vector<long> ids;
+        for (const auto& [id, hash] : baseline) {
+            if (!seen.count(id)) ids.push_back(id);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    // 以下按最终内容统计：中途改过又改回来的学号算作未变
+    auto updated_count() const -> std::size_t { return baseline_matches(false); }
+    auto unchanged_count() const -> std::size_t { return baseline_matches(true); }
+    auto file_count() const -> std::size_t { return seen.size(); }
+
+private:
+    auto baseline_matches(bool same) const -> std::size_t {
+        std::size_t n = 0;
+        for (const auto& [id, entry] : seen) {
+            const auto base = baseline.find(id);
+            if (base != baseline.end() && (base->second == entry.hash) == same) ++n;
+        }
+        return n;
+    }
+};
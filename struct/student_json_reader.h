@@ -0,0 +1,488 @@
+#pragma once
+
+#include "json_scan.h"
+#include "stu_with_score.h"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// -- direct JSON -> Stu_withScore --
+// 把一个学生对象的 JSON 文本直接解码成 Stu_withScore，不经过 QJsonDocument / QJsonObject，
+// 字符串也不经过 QString 中转。空白和字符串内容按 8 字节一组扫描（json_scan.h），
+// 整组都是普通字符时一次跳过。
+//
+// 结果与 stu_with_score_from_qjson 完全一致，包括它的宽松规则：缺少的字段取默认值，
+// 类型不符的字段按 QJsonValue 的 toString / toInt / toDouble / toObject / toArray 取空值或 0
+// （例如数字形式的 class_id 得到 0，5.5 的 toInt 得到 0）；Symbol 和课程名的登记顺序
+// 也与 Qt 路径相同（课程按名字排序后登记，和 QJsonObject 的遍历顺序一样）。
+// 少数不值得逐条复现的情况直接返回 nullopt，由调用方交给 QJsonDocument + stu_with_score_from_qjson，
+// 得到与原来相同的结果或错误：语法错误、非法 UTF-8、\u 转义的孤立代理项或非字符、
+// 同一对象里重复的已知字段或课程名、不是整数的 id、不是纯数字的 class_id 字符串、
+// 含 BMP 以外字符的课程名、嵌套超过 kMaxDepth 层。
+
+class StudentJsonReader {
+public:
+    static constexpr int kMaxDepth = 64;
+
+    static auto parse(std::string_view json) -> std::optional<Stu_withScore> {
+        StudentJsonReader reader(json);
+        Fields f;
+        if (!reader.student(f)) return std::nullopt;
+        reader.skip_ws();
+        if (reader.p != reader.end) return std::nullopt;
+        std::optional<Stu_withScore> out(std::in_place); // Stu_withScore 没有移动构造，直接在返回值里填写
+        assemble(f, *out);
+        return out;
+    }
+
+private:
+    // 解析阶段先存成普通字符串，最后按 student_from_qjson 的顺序生成 Symbol 和 CourseId
+    struct Fields {
+        long long id{0};
+        std::string name;
+        std::string sex;
+        Date birthdate;
+        int enrollYear{0};
+        std::string major;
+        int classId{0};
+        Contact contact;
+        std::string province;
+        std::string city;
+        std::string status;
+        std::vector<FamilyMember> family;
+        std::vector<std::string> relationships; // 与 family 一一对应
+        std::vector<std::pair<std::string, Score>> scores;
+    };
+
+    struct Number {
+        bool integer{true};
+        long long i{0};
+        double d{0};
+    };
+
+    const char* p;
+    const char* end;
+    int depth{0};
+    std::string key;  // 当前字段名，嵌套解析会覆盖它
+    std::string text; // 被忽略的字符串值
+
+    explicit StudentJsonReader(std::string_view json) : p(json.data()), end(json.data() + json.size()) {}
+
+    static auto is_digit(char c) -> bool { return c >= '0' && c <= '9'; }
+
+    static auto is_noncharacter(std::uint32_t cp) -> bool {
+        return (cp >= 0xFDD0 && cp <= 0xFDEF) || (cp & 0xFFFE) == 0xFFFE;
+    }
+
+    static auto once(unsigned& seen, unsigned bit) -> bool {
+        if (seen & bit) return false;
+        seen |= bit;
+        return true;
+    }
+
+    static void assemble(Fields& f, Stu_withScore& stu) {
+        stu.set_id(static_cast<long>(f.id));
+        stu.set_name(f.name);
+        stu.set_sex(f.sex == "Female" ? Sex::Female : Sex::Male);
+        stu.set_birthdate(f.birthdate);
+        stu.set_enroll_year(f.enrollYear);
+        stu.set_major(f.major);
+        stu.set_class(f.classId);
+        stu.set_contact(f.contact);
+        stu.set_address(Address(f.province, f.city));
+        stu.set_status(f.status == "Leave"       ? Status::Leave
+                       : f.status == "Graduated" ? Status::Graduated
+                                                 : Status::Active);
+        for (std::size_t i = 0; i < f.family.size(); ++i) f.family[i].relationship = Symbol(f.relationships[i]);
+        stu.set_family_members(f.family);
+        stu.reserve_scores(f.scores.size());
+        for (const auto& [course, score] : f.scores) stu.add_score(intern_course(course), score);
+    }
+
+    void skip_ws() {
+        while (end - p >= 8 && json_load8(p) == kJsonOnes * ' ') p += 8; // 缩进
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+    }
+
+    auto peek() -> char {
+        skip_ws();
+        return p < end ? *p : '\0';
+    }
+
+    auto consume(char c) -> bool {
+        if (peek() != c) return false;
+        ++p;
+        return true;
+    }
+
+    auto literal(std::string_view word) -> bool {
+        if (static_cast<std::size_t>(end - p) < word.size() || std::string_view(p, word.size()) != word) return false;
+        p += word.size();
+        return true;
+    }
+
+    // member(key) 必须在解析值之前用完 key
+    template<typename F>
+    auto object(F&& member) -> bool {
+        if (++depth > kMaxDepth || !consume('{')) return false;
+        if (!consume('}')) {
+            do {
+                if (!string(key) || !consume(':') || !member(std::string_view(key))) return false;
+            } while (consume(','));
+            if (!consume('}')) return false;
+        }
+        --depth;
+        return true;
+    }
+
+    template<typename F>
+    auto array(F&& element) -> bool {
+        if (++depth > kMaxDepth || !consume('[')) return false;
+        if (!consume(']')) {
+            do {
+                if (!element()) return false;
+            } while (consume(','));
+            if (!consume(']')) return false;
+        }
+        --depth;
+        return true;
+    }
+
+    auto skip() -> bool {
+        switch (peek()) {
+            case '"': return string(text);
+            case '{': return object([this] (std::string_view) { return skip(); });
+            case '[': return array([this] { return skip(); });
+            case 't': return literal("true");
+            case 'f': return literal("false");
+            case 'n': return literal("null");
+            default: {
+                Number n;
+                return number(n);
+            }
+        }
+    }
+
+    // -- strings --
+
+    auto string(std::string& out) -> bool {
+        if (peek() != '"') return false;
+        ++p;
+        out.clear();
+        const char* run = p; // 还没复制到 out 的一段
+        for (;;) {
+            while (end - p >= 8) {
+                const std::uint64_t w = json_load8(p);
+                if (json_has_string_special(w) || json_has_non_ascii(w)) break;
+                p += 8;
+            }
+            if (p >= end) return false;
+            const auto c = static_cast<unsigned char>(*p);
+            if (c == '"') {
+                out.append(run, p);
+                ++p;
+                return true;
+            }
+            if (c == '\\') {
+                out.append(run, p);
+                if (!escape(out)) return false;
+                run = p;
+            } else if (c < 0x20) {
+                return false;
+            } else if (c >= 0x80) {
+                if (!utf8_sequence()) return false;
+            } else {
+                ++p;
+            }
+        }
+    }
+
+    // 校验一个多字节 UTF-8 序列：拒绝过长编码、代理项和非字符，和 Qt 的解码器一样严格或更严格
+    auto utf8_sequence() -> bool {
+        const auto* s             = reinterpret_cast<const unsigned char*>(p);
+        const std::ptrdiff_t left = end - p;
+        auto cont = [&] (std::ptrdiff_t k, unsigned char lo = 0x80, unsigned char hi = 0xBF) {
+            return k < left && s[k] >= lo && s[k] <= hi;
+        };
+        std::uint32_t cp;
+        int n;
+        if (s[0] >= 0xC2 && s[0] <= 0xDF) {
+            if (!cont(1)) return false;
+            cp = (s[0] & 0x1Fu) << 6 | (s[1] & 0x3Fu);
+            n  = 2;
+        } else if (s[0] >= 0xE0 && s[0] <= 0xEF) {
+            if (!cont(1, s[0] == 0xE0 ? 0xA0 : 0x80, s[0] == 0xED ? 0x9F : 0xBF) || !cont(2)) return false;
+            cp = (s[0] & 0x0Fu) << 12 | (s[1] & 0x3Fu) << 6 | (s[2] & 0x3Fu);
+            n  = 3;
+        } else if (s[0] >= 0xF0 && s[0] <= 0xF4) {
+            if (!cont(1, s[0] == 0xF0 ? 0x90 : 0x80, s[0] == 0xF4 ? 0x8F : 0xBF) || !cont(2) || !cont(3)) return false;
+            cp = (s[0] & 0x07u) << 18 | (s[1] & 0x3Fu) << 12 | (s[2] & 0x3Fu) << 6 | (s[3] & 0x3Fu);
+            n  = 4;
+        } else {
+            return false;
+        }
+        if (is_noncharacter(cp)) return false;
+        p += n;
+        return true;
+    }
+
+    auto hex4(std::uint32_t& v) -> bool {
+        if (end - p < 4) return false;
+        v = 0;
+        for (int i = 0; i < 4; ++i, ++p) {
+            const char c = *p;
+            v <<= 4;
+            if (c >= '0' && c <= '9') v |= static_cast<std::uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') v |= static_cast<std::uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') v |= static_cast<std::uint32_t>(c - 'A' + 10);
+            else return false;
+        }
+        return true;
+    }
+
+    auto escape(std::string& out) -> bool {
+        if (end - p < 2) return false;
+        const char c = p[1];
+        p += 2;
+        switch (c) {
+            case '"': out.push_back('"'); return true;
+            case '\\': out.push_back('\\'); return true;
+            case '/': out.push_back('/'); return true;
+            case 'b': out.push_back('\b'); return true;
+            case 'f': out.push_back('\f'); return true;
+            case 'n': out.push_back('\n'); return true;
+            case 'r': out.push_back('\r'); return true;
+            case 't': out.push_back('\t'); return true;
+            case 'u': break;
+            default: return false;
+        }
+        std::uint32_t cp;
+        if (!hex4(cp) || (cp >= 0xDC00 && cp <= 0xDFFF)) return false;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            std::uint32_t low;
+            if (end - p < 2 || p[0] != '\\' || p[1] != 'u') return false;
+            p += 2;
+            if (!hex4(low) || low < 0xDC00 || low > 0xDFFF) return false;
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if (is_noncharacter(cp)) return false;
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | cp >> 6));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | cp >> 12));
+            out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | cp >> 18));
+            out.push_back(static_cast<char>(0x80 | (cp >> 12 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        return true;
+    }
+
+    // -- numbers --
+
+    // 严格按 JSON 语法；不带小数和指数、且能放进 64 位的是整数，其余是 double（与 QJsonDocument 相同）
+    auto number(Number& n) -> bool {
+        skip_ws();
+        const char* start = p;
+        if (p < end && *p == '-') ++p;
+        if (p < end && *p == '0') {
+            ++p;
+        } else if (p < end && *p >= '1' && *p <= '9') {
+            while (p < end && is_digit(*p)) ++p;
+        } else {
+            return false;
+        }
+        bool integer = true;
+        auto digits = [this] {
+            const char* first = p;
+            while (p < end && is_digit(*p)) ++p;
+            return p != first;
+        };
+        if (p < end && *p == '.') {
+            ++p;
+            if (!digits()) return false;
+            integer = false;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            ++p;
+            if (p < end && (*p == '+' || *p == '-')) ++p;
+            if (!digits()) return false;
+            integer = false;
+        }
+        if (integer && std::from_chars(start, p, n.i).ec == std::errc()) {
+            n.integer = true;
+            return true;
+        }
+        n.integer = false;
+        // 超出 double 范围时交给回退路径按 Qt 的规则报错
+        return std::from_chars(start, p, n.d).ec == std::errc();
+    }
+
+    // -- QJsonValue conversions --
+
+    // toString()：不是字符串时为空
+    auto to_string(std::string& out) -> bool {
+        if (peek() == '"') return string(out);
+        out.clear();
+        return skip();
+    }
+
+    // toInt()：在 int 范围内的整数，或值为整数的 double；其它为 0
+    auto to_int(int& out) -> bool {
+        out          = 0;
+        const char c = peek();
+        if (c != '-' && !is_digit(c)) return skip();
+        Number n;
+        if (!number(n)) return false;
+        if (n.integer) {
+            if (n.i >= INT_MIN && n.i <= INT_MAX) out = static_cast<int>(n.i);
+        } else if (n.d >= INT_MIN && n.d <= INT_MAX && n.d == std::trunc(n.d)) {
+            out = static_cast<int>(n.d);
+        }
+        return true;
+    }
+
+    // toDouble()：数字的值，其它为 0
+    auto to_double(double& out) -> bool {
+        out          = 0;
+        const char c = peek();
+        if (c != '-' && !is_digit(c)) return skip();
+        Number n;
+        if (!number(n)) return false;
+        out = n.integer ? static_cast<double>(n.i) : n.d;
+        return true;
+    }
+
+    // -- student fields --
+
+    // toVariant().toLongLong()：只处理整数
+    auto id(long long& out) -> bool {
+        Number n;
+        if (!number(n) || !n.integer) return false;
+        out = n.i;
+        return true;
+    }
+
+    // toString().toInt()：非字符串为 0；字符串只处理空串和纯数字
+    auto class_id(int& out) -> bool {
+        out = 0;
+        if (peek() != '"') return skip();
+        if (!string(text)) return false;
+        if (text.empty()) return true;
+        const char* last = text.data() + text.size();
+        const auto res   = std::from_chars(text.data(), last, out);
+        return res.ec == std::errc() && res.ptr == last;
+    }
+
+    auto date(Date& d) -> bool {
+        if (peek() != '{') return skip(); // toObject() 为空，各字段取 0
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "year") return once(seen, 1u << 0) && to_int(d.year);
+            if (k == "month") return once(seen, 1u << 1) && to_int(d.month);
+            if (k == "day") return once(seen, 1u << 2) && to_int(d.day);
+            return skip();
+        });
+    }
+
+    auto contact(Contact& c) -> bool {
+        if (peek() != '{') return skip();
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "phone") return once(seen, 1u << 0) && to_string(c.phone);
+            if (k == "email") return once(seen, 1u << 1) && to_string(c.email);
+            return skip();
+        });
+    }
+
+    auto address(Fields& f) -> bool {
+        if (peek() != '{') return skip();
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "province") return once(seen, 1u << 0) && to_string(f.province);
+            if (k == "city") return once(seen, 1u << 1) && to_string(f.city);
+            return skip();
+        });
+    }
+
+    auto family_member(Fields& f) -> bool {
+        FamilyMember& fm = f.family.emplace_back();
+        std::string& rel = f.relationships.emplace_back();
+        if (peek() != '{') return skip(); // 非对象元素得到一个空的家庭成员
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "name") return once(seen, 1u << 0) && to_string(fm.name);
+            if (k == "relationship") return once(seen, 1u << 1) && to_string(rel);
+            if (k == "contactInfo") return once(seen, 1u << 2) && contact(fm.contactInfo);
+            return skip();
+        });
+    }
+
+    auto family(Fields& f) -> bool {
+        if (peek() != '[') return skip();
+        return array([&] { return family_member(f); });
+    }
+
+    auto score(Score& s) -> bool {
+        if (peek() != '{') return skip(); // toObject() 为空，得到 Score(0, 0)
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "score") return once(seen, 1u << 0) && to_double(s.score);
+            if (k == "gpa") return once(seen, 1u << 1) && to_double(s.gpa);
+            return skip();
+        });
+    }
+
+    auto scores(Fields& f) -> bool {
+        if (peek() != '{') return skip();
+        const bool ok = object([&] (std::string_view course) {
+            // UTF-8 字节序只在 BMP 内与 QString 的 UTF-16 排序一致
+            if (std::any_of(course.begin(), course.end(), [] (char c) { return static_cast<unsigned char>(c) >= 0xF0; }))
+                return false;
+            auto& entry = f.scores.emplace_back(std::string(course), Score());
+            return score(entry.second);
+        });
+        if (!ok) return false;
+        // QJsonObject 按键名排序遍历，课程按同样的顺序登记
+        std::sort(f.scores.begin(), f.scores.end(),
+                  [] (const auto& a, const auto& b) { return a.first < b.first; });
+        return std::adjacent_find(f.scores.begin(), f.scores.end(), [] (const auto& a, const auto& b) {
+                   return a.first == b.first;
+               }) == f.scores.end();
+    }
+
+    auto student(Fields& f) -> bool {
+        if (peek() != '{') return false;
+        unsigned seen = 0;
+        return object([&] (std::string_view k) {
+            if (k == "id") return once(seen, 1u << 0) && id(f.id);
+            if (k == "name") return once(seen, 1u << 1) && to_string(f.name);
+            if (k == "sex") return once(seen, 1u << 2) && to_string(f.sex);
+            if (k == "birthdate") return once(seen, 1u << 3) && date(f.birthdate);
+            if (k == "enrollYear") return once(seen, 1u << 4) && to_int(f.enrollYear);
+            if (k == "major") return once(seen, 1u << 5) && to_string(f.major);
+            if (k == "class_id") return once(seen, 1u << 6) && class_id(f.classId);
+            if (k == "contact") return once(seen, 1u << 7) && contact(f.contact);
+            if (k == "address") return once(seen, 1u << 8) && address(f);
+            if (k == "status") return once(seen, 1u << 9) && to_string(f.status);
+            if (k == "familyMembers") return once(seen, 1u << 10) && family(f);
+            if (k == "scores") return once(seen, 1u << 11) && scores(f);
+            return skip();
+        });
+    }
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include "student_store.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// -- paged / sorted / filtered queries over StudentStore --
+// 过滤在一次遍历中完成；排序只对需要的窗口做 nth_element + partial_sort，
+// 不序列化、也不整体排序不在当前页中的学生。
+
+enum class StudentSortKey { Id, Name, Age, EnrollYear, Major, Class, Status };
+
+struct StudentFilter {
+    std::optional<Symbol> major; // 按 Symbol id 比较，不逐字节比较字符串
+    std::optional<int> classId;
+    int enrollYearMin{INT_MIN};
+    int enrollYearMax{INT_MAX};
+    std::optional<Status> status;
+    std::string keyword; // 姓名或学号包含该子串
+    bool matchNone{false}; // 过滤的专业不在符号表中，没有学生能匹配
+
+    bool matches(const Student& stu) const {
+        if (matchNone) return false;
+        if (major && stu.get_major_symbol() != *major) return false;
+        if (classId && stu.get_class() != *classId) return false;
+        if (stu.get_enroll_year() < enrollYearMin || stu.get_enroll_year() > enrollYearMax) return false;
+        if (status && stu.get_status() != *status) return false;
+        if (!keyword.empty()
+            && stu.get_name().find(keyword) == std::string::npos
+            && std::to_string(stu.get_id()).find(keyword) == std::string::npos) {
+            return false;
+        }
+        return true;
+    }
+};
+
+struct StudentQuery {
+    StudentFilter filter;
+    StudentSortKey sortKey{StudentSortKey::Id};
+    bool descending{false};
+    std::size_t offset{0};
+    std::size_t limit{50};
+};
+
+struct StudentPage {
+    std::vector<const Stu_withScore*> rows; // 指向 store 内部，store 修改后失效
+    std::size_t total{0};                   // 过滤后的总数
+};
+
+// 按 key 比较，相等时按学号，保证分页顺序稳定
+inline bool student_less(const Student& a, const Student& b, StudentSortKey key) {
+    switch (key) {
+        case StudentSortKey::Name:
+            if (a.get_name() != b.get_name()) return a.get_name() < b.get_name();
+            break;
+        case StudentSortKey::Age:
+            if (a.get_age() != b.get_age()) return a.get_age() < b.get_age();
+            break;
+        case StudentSortKey::EnrollYear:
+            if (a.get_enroll_year() != b.get_enroll_year()) return a.get_enroll_year() < b.get_enroll_year();
+            break;
+        case StudentSortKey::Major:
+            if (a.get_major() != b.get_major()) return a.get_major() < b.get_major();
+            break;
+        case StudentSortKey::Class:
+            if (a.get_class() != b.get_class()) return a.get_class() < b.get_class();
+            break;
+        case StudentSortKey::Status:
+            if (a.get_status() != b.get_status()) return a.get_status() < b.get_status();
+            break;
+        case StudentSortKey::Id:
+            break;
+    }
+    return a.get_id() < b.get_id();
+}
+
+// 对已经过滤好的学生排序、分页；matched 会被重排
+inline auto page_students(std::vector<const Stu_withScore*> matched, const StudentQuery& q) -> StudentPage {
+    StudentPage page;
+    page.total = matched.size();
+    if (q.offset >= matched.size() || q.limit == 0) return page;
+
+    auto cmp = [&] (const Stu_withScore* a, const Stu_withScore* b) {
+        return q.descending ? student_less(*b, *a, q.sortKey) : student_less(*a, *b, q.sortKey);
+    };
+    auto first = matched.begin() + static_cast<std::ptrdiff_t>(q.offset);
+    auto last  = matched.begin() + static_cast<std::ptrdiff_t>(std::min(matched.size() - q.offset, q.limit) + q.offset);
+    if (first != matched.begin()) {
+        std::nth_element(matched.begin(), first, matched.end(), cmp);
+    }
+    std::partial_sort(first, last, matched.end(), cmp);
+    page.rows.assign(first, last);
+    return page;
+}
+
+inline auto query_students(const StudentStore& store, const StudentQuery& q) -> StudentPage {
+    std::vector<const Stu_withScore*> matched;
+    store.for_each([&] (const Stu_withScore& stu) {
+        if (q.filter.matches(stu)) matched.push_back(&stu);
+    });
+    return page_students(std::move(matched), q);
+}
+
+// -- facet counts --
+// 专业、省、市、家庭成员关系各取值的数量，供页面做分面筛选。
+// Symbol id 连续，计数用数组而不是哈希表；空值不计入。
+
+enum class StudentFacet { Major, Province, City, Relationship };
+
+struct FacetCount {
+    Symbol value;
+    std::size_t count{0};
+};
+
+// 只统计满足 filter 的学生，家庭成员关系按人计；按数量降序，相同时按取值
+inline auto student_facet_counts(const StudentStore& store, StudentFacet facet, const StudentFilter& filter = {})
+    -> std::vector<FacetCount> {
+    // store 里的字段都已经在池中，池此后再增长也不会出现更大的 id
+    std::vector<std::size_t> counts(Symbol::pool().size(), 0);
+    store.for_each([&] (const Stu_withScore& stu) {
+        if (!filter.matches(stu)) return;
+        switch (facet) {
+            case StudentFacet::Major: ++counts[stu.get_major_symbol().get_id()]; break;
+            case StudentFacet::Province: ++counts[stu.get_address().province.get_id()]; break;
+            case StudentFacet::City: ++counts[stu.get_address().city.get_id()]; break;
+            case StudentFacet::Relationship:
+                for (const auto& member : stu.get_family_members()) ++counts[member.relationship.get_id()];
+                break;
+        }
+    });
+
+    std::vector<FacetCount> out;
+    for (std::size_t id = 1; id < counts.size(); ++id) {
+        if (counts[id]) out.push_back({Symbol::from_id(static_cast<std::uint32_t>(id)), counts[id]});
+    }
+    std::sort(out.begin(), out.end(), [] (const FacetCount& a, const FacetCount& b) {
+        if (a.count != b.count) return a.count > b.count;
+        return a.value.str() < b.value.str();
+    });
+    return out;
+}
+
+// -- JSON conversions for StudentQuery --
+#ifdef USE_QTJSON
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+inline auto student_sort_key_from_qjson_string(const QString& str) -> StudentSortKey {
+    if (str == "name") return StudentSortKey::Name;
+    else if (str == "age") return StudentSortKey::Age;
+    else if (str == "enrollYear") return StudentSortKey::EnrollYear;
+    else if (str == "major") return StudentSortKey::Major;
+    else if (str == "class_id") return StudentSortKey::Class;
+    else if (str == "status") return StudentSortKey::Status;
+    return StudentSortKey::Id;
+}
+
+// {"offset", "limit", "sortKey", "sortOrder": "asc"|"desc",
+//  "filters": {"major", "class_id", "enrollYearMin", "enrollYearMax", "status", "keyword"}}
+inline auto student_query_from_qjson(const QJsonObject& obj) -> StudentQuery {
+    StudentQuery q;
+    q.offset     = static_cast<std::size_t>(std::max<qint64>(0, obj["offset"].toVariant().toLongLong()));
+    q.limit      = static_cast<std::size_t>(std::max<qint64>(0, obj["limit"].toVariant().toLongLong()));
+    q.sortKey    = student_sort_key_from_qjson_string(obj["sortKey"].toString());
+    q.descending = obj["sortOrder"].toString() == "desc";
+    if (!obj.contains("limit")) q.limit = 50;
+
+    QJsonObject f = obj["filters"].toObject();
+    // 只查找不登记：页面传来的任意字符串不能让符号表无限增长
+    if (!f["major"].toString().isEmpty()) {
+        q.filter.major     = Symbol::find(f["major"].toString().toStdString());
+        q.filter.matchNone = !q.filter.major;
+    }
+    if (f.contains("class_id") && !f["class_id"].toVariant().toString().isEmpty()) {
+        q.filter.classId = f["class_id"].toVariant().toInt();
+    }
+    if (f.contains("enrollYearMin")) q.filter.enrollYearMin = f["enrollYearMin"].toInt(INT_MIN);
+    if (f.contains("enrollYearMax")) q.filter.enrollYearMax = f["enrollYearMax"].toInt(INT_MAX);
+    if (!f["status"].toString().isEmpty()) q.filter.status = status_from_qjson_string(f["status"].toString());
+    q.filter.keyword = f["keyword"].toString().toStdString();
+    return q;
+}
+
+inline auto student_facet_from_qjson_string(const QString& str) -> std::optional<StudentFacet> {
+    if (str == "major") return StudentFacet::Major;
+    else if (str == "province") return StudentFacet::Province;
+    else if (str == "city") return StudentFacet::City;
+    else if (str == "relationship") return StudentFacet::Relationship;
+    return std::nullopt;
+}
+
+inline auto facet_counts_to_qjson(const std::vector<FacetCount>& counts) -> QJsonArray {
+    QJsonArray arr;
+    for (const auto& c : counts) {
+        QJsonObject obj;
+        obj["value"] = QString::fromStdString(c.value.str());
+        obj["count"] = static_cast<qint64>(c.count);
+        arr.append(obj);
+    }
+    return arr;
+}
+
+#endif // USE_QTJSON
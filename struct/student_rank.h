@@ -0,0 +1,472 @@
+#pragma once
+
+#include "student_store.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -- order-statistic rank indexes --
+// 每个排名范围（全体 / 专业 / 班级 / 课程）× 指标（平均分 / GPA）一棵顺序统计树，
+// 按 (分数降序, 学号升序) 排列，节点记子树大小。
+// 插入、删除、“某学生排第几”、“第 k 名是谁”都是 O(log n)，取第 100~150 名是 O(log n + 50)，
+// 不需要每次整体排序。
+
+class RankTree {
+public:
+    struct Key {
+        double value;
+        long id;
+    };
+
+private:
+    static constexpr std::uint32_t nil = UINT32_MAX;
+
+    // 树堆（treap）：按键是二叉搜索树，按随机优先级是堆，期望深度 O(log n)
+    struct Node {
+        Key key;
+        std::uint32_t priority;
+        std::uint32_t size;
+        std::uint32_t left;
+        std::uint32_t right;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::uint32_t root{nil};
+    std::uint64_t seed{0x9E3779B97F4A7C15ull};
+
+    static bool before(const Key& a, const Key& b) {
+        if (a.value != b.value) return a.value > b.value;
+        return a.id < b.id;
+    }
+
+    auto size_of(std::uint32_t t) const -> std::uint32_t { return t == nil ? 0 : nodes[t].size; }
+
+    void pull(std::uint32_t t) { nodes[t].size = 1 + size_of(nodes[t].left) + size_of(nodes[t].right); }
+
+    auto next_priority() -> std::uint32_t {
+        // xorshift64*，只用来打散优先级
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
+        return static_cast<std::uint32_t>((seed * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    // l 为严格排在 key 之前的部分，r 为其余
+    void split(std::uint32_t t, const Key& key, std::uint32_t& l, std::uint32_t& r) {
+        if (t == nil) {
+            l = r = nil;
+            return;
+        }
+        if (before(nodes[t].key, key)) {
+            split(nodes[t].right, key, nodes[t].right, r);
+            l = t;
+        } else {
+            split(nodes[t].left, key, l, nodes[t].left);
+            r = t;
+        }
+        pull(t);
+    }
+
+    auto merge(std::uint32_t a, std::uint32_t b) -> std::uint32_t {
+        if (a == nil) return b;
+        if (b == nil) return a;
+        if (nodes[a].priority > nodes[b].priority) {
+            nodes[a].right = merge(nodes[a].right, b);
+            pull(a);
+            return a;
+        }
+        nodes[b].left = merge(a, nodes[b].left);
+        pull(b);
+        return b;
+    }
+
+    auto erase(std::uint32_t t, const Key& key, bool& found) -> std::uint32_t {
+        if (t == nil) return nil;
+        const Key& k = nodes[t].key;
+        if (k.id == key.id && k.value == key.value) {
+            found = true;
+            freeNodes.push_back(t);
+            return merge(nodes[t].left, nodes[t].right);
+        }
+        if (before(key, k)) {
+            nodes[t].left = erase(nodes[t].left, key, found);
+        } else {
+            nodes[t].right = erase(nodes[t].right, key, found);
+        }
+        pull(t);
+        return t;
+    }
+
+    void fix_sizes(std::uint32_t t) {
+        if (t == nil) return;
+        fix_sizes(nodes[t].left);
+        fix_sizes(nodes[t].right);
+        pull(t);
+    }
+
+    void collect(std::uint32_t t, std::size_t& skip, std::size_t& remaining, std::vector<Key>& out) const {
+        if (t == nil || remaining == 0) return;
+        const std::size_t leftSize = size_of(nodes[t].left);
+        if (skip >= leftSize) {
+            skip -= leftSize;
+        } else {
+            collect(nodes[t].left, skip, remaining, out);
+        }
+        if (remaining == 0) return;
+        if (skip > 0) {
+            --skip;
+        } else {
+            out.push_back(nodes[t].key);
+            --remaining;
+        }
+        collect(nodes[t].right, skip, remaining, out);
+    }
+
+public:
+    auto size() const -> std::size_t { return size_of(root); }
+    bool empty() const { return root == nil; }
+
+    void clear() {
+        nodes.clear();
+        freeNodes.clear();
+        root = nil;
+    }
+
+    // 整体重建：排序后用栈按优先级一次建成笛卡尔树，O(n log n) 且节点按名次连续存放，
+    // 比逐个 insert 少大量随机访存
+    void assign(std::vector<Key> keys) {
+        clear();
+        std::sort(keys.begin(), keys.end(), before);
+        nodes.reserve(keys.size());
+        std::vector<std::uint32_t> spine; // 当前的右链
+        for (const Key& key : keys) {
+            const auto n = static_cast<std::uint32_t>(nodes.size());
+            nodes.push_back({key, next_priority(), 1, nil, nil});
+            std::uint32_t last = nil;
+            while (!spine.empty() && nodes[spine.back()].priority < nodes[n].priority) {
+                last = spine.back();
+                spine.pop_back();
+            }
+            nodes[n].left = last;
+            if (!spine.empty()) nodes[spine.back()].right = n;
+            spine.push_back(n);
+        }
+        root = spine.empty() ? nil : spine.front();
+        fix_sizes(root);
+    }
+
+    // 同一个 (value, id) 只应插入一次，由调用方保证
+    void insert(const Key& key) {
+        std::uint32_t n;
+        if (!freeNodes.empty()) {
+            n = freeNodes.back();
+            freeNodes.pop_back();
+        } else {
+            n = static_cast<std::uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[n] = {key, next_priority(), 1, nil, nil};
+        std::uint32_t l, r;
+        split(root, key, l, r);
+        root = merge(merge(l, n), r);
+    }
+
+    bool erase(const Key& key) {
+        bool found = false;
+        root       = erase(root, key, found);
+        return found;
+    }
+
+    // 排在 key 之前的元素个数（即从 0 开始的名次）
+    auto position(const Key& key) const -> std::size_t {
+        std::size_t before_count = 0;
+        std::uint32_t t          = root;
+        while (t != nil) {
+            if (before(nodes[t].key, key)) {
+                before_count += size_of(nodes[t].left) + 1;
+                t = nodes[t].right;
+            } else {
+                t = nodes[t].left;
+            }
+        }
+        return before_count;
+    }
+
+    // 分数严格高于 value 的元素个数；加 1 即并列时共享的名次
+    auto count_above(double value) const -> std::size_t { return position({value, LONG_MIN}); }
+
+    // 按名次从 offset 开始取至多 count 个
+    auto range(std::size_t offset, std::size_t count) const -> std::vector<Key> {
+        std::vector<Key> out;
+        if (offset >= size()) return out;
+        out.reserve(std::min(count, size() - offset));
+        collect(root, offset, count, out);
+        return out;
+    }
+};
+
+enum class RankScope { All, Major, Class, Course };
+enum class RankMetric { Average, Gpa }; // 课程范围内为该课的分数 / 绩点
+
+struct RankEntry {
+    long id{};
+    double value{};
+    std::size_t position{}; // 从 1 开始，同分按学号先后
+    std::size_t rank{};     // 从 1 开始，同分并列
+};
+
+struct RankQuery {
+    RankScope scope{RankScope::All};
+    std::string key; // 专业名、班级号或课程名；全体排名时忽略
+    RankMetric metric{RankMetric::Average};
+    std::size_t offset{0};
+    std::size_t limit{50};
+};
+
+// 排名只用到的字段。专业和课程都存名字表里的 id，不引用 StudentStore，
+// 整体重建时可以先在 GUI 线程抄出来，再交给后台线程建树
+struct RankSource {
+    long id{};
+    Symbol major;
+    int classId{};
+    double average{};
+    double gpa{};
+    std::vector<std::pair<CourseId, Score>> scores;
+};
+
+inline auto rank_source_of(const Stu_withScore& student) -> RankSource {
+    return {student.get_id(), student.get_major_symbol(), student.get_class(), student.calculate_average(),
+            student.calculate_gpa(), student.get_all_scores().raw()};
+}
+
+inline auto rank_sources(const StudentStore& store) -> std::vector<RankSource> {
+    std::vector<RankSource> sources;
+    sources.reserve(store.size());
+    store.for_each([&] (const Stu_withScore& student) {
+        if (!student.get_all_scores().empty()) sources.push_back(rank_source_of(student));
+    });
+    return sources;
+}
+
+// 一名学生在某个排名范围内的位置
+struct StudentRank {
+    RankScope scope;
+    std::string key;
+    RankMetric metric;
+    RankEntry entry;
+    std::size_t total;
+};
+
+class StudentRankings {
+    using Trees = std::unordered_map<std::string, RankTree>;
+    using Tree  = Trees::value_type; // 节点地址在 rehash 后不变，可以长期持有
+
+    // 学生在某棵树中的键；树为空时才会被删除，此时已没有学生指向它
+    struct Placement {
+        RankScope scope;
+        RankMetric metric;
+        double value;
+        Tree* tree;
+    };
+
+    std::array<std::array<Trees, 2>, 4> trees;
+    std::unordered_map<long, std::vector<Placement>> placed;
+
+    auto trees_for(RankScope scope, RankMetric metric) -> Trees& {
+        return trees[static_cast<std::size_t>(scope)][static_cast<std::size_t>(metric)];
+    }
+
+    auto trees_for(RankScope scope, RankMetric metric) const -> const Trees& {
+        return trees[static_cast<std::size_t>(scope)][static_cast<std::size_t>(metric)];
+    }
+
+    auto find_tree(RankScope scope, const std::string& key, RankMetric metric) const -> const RankTree* {
+        const Trees& t = trees_for(scope, metric);
+        auto it        = t.find(scope == RankScope::All ? std::string() : key);
+        return it == t.end() ? nullptr : &it->second;
+    }
+
+    static auto entry_in(const RankTree& tree, const RankTree::Key& key) -> RankEntry {
+        return {key.id, key.value, tree.position(key) + 1, tree.count_above(key.value) + 1};
+    }
+
+    // 没有成绩的学生不参与平均分 / GPA 排名，返回空；用到的树不存在时先建一棵空树
+    auto placements_of(const RankSource& student) -> std::vector<Placement> {
+        std::vector<Placement> list;
+        const auto& scores = student.scores;
+        if (scores.empty()) return list;
+
+        auto add = [&] (RankScope scope, const std::string& key, RankMetric metric, double value) {
+            list.push_back({scope, metric, value, &*trees_for(scope, metric).try_emplace(key).first});
+        };
+        const std::string classKey = std::to_string(student.classId);
+        list.reserve(6 + scores.size() * 2);
+        for (const auto& [scope, key] : {std::pair<RankScope, const std::string*>{RankScope::All, nullptr},
+                                         {RankScope::Major, &student.major.str()},
+                                         {RankScope::Class, &classKey}}) {
+            add(scope, key ? *key : std::string(), RankMetric::Average, student.average);
+            add(scope, key ? *key : std::string(), RankMetric::Gpa, student.gpa);
+        }
+        for (const auto& [course, score] : scores) {
+            add(RankScope::Course, course_name(course), RankMetric::Average, score.score);
+            add(RankScope::Course, course_name(course), RankMetric::Gpa, score.gpa);
+        }
+        return list;
+    }
+
+public:
+    void clear() {
+        for (auto& byMetric : trees) {
+            for (auto& t : byMetric) t.clear();
+        }
+        placed.clear();
+    }
+
+    // 先收集每棵树的全部键再整体建树，每棵树排序一次，共 O(n log n)。
+    // 只读 sources 和名字表，可以在任意线程建好后移动给使用方；移动不改变树节点的地址
+    void rebuild(const std::vector<RankSource>& sources) {
+        clear();
+        placed.reserve(sources.size());
+        std::unordered_map<Tree*, std::vector<RankTree::Key>> keys;
+        for (const RankSource& student : sources) {
+            std::vector<Placement> list = placements_of(student);
+            if (list.empty()) continue;
+            for (const Placement& p : list) keys[p.tree].push_back({p.value, student.id});
+            placed[student.id] = std::move(list);
+        }
+        for (auto& [tree, list] : keys) tree->second.assign(std::move(list));
+    }
+
+    void rebuild(const StudentStore& store) { rebuild(rank_sources(store)); }
+
+    void upsert(const Stu_withScore& student) {
+        const long id = student.get_id();
+        erase(id);
+        std::vector<Placement> list = placements_of(rank_source_of(student));
+        if (list.empty()) return;
+        for (const Placement& p : list) p.tree->second.insert({p.value, id});
+        placed[id] = std::move(list);
+    }
+
+    bool erase(long id) {
+        auto it = placed.find(id);
+        if (it == placed.end()) return false;
+        for (const Placement& p : it->second) {
+            p.tree->second.erase({p.value, id});
+            if (p.tree->second.empty()) {
+                Trees& t = trees_for(p.scope, p.metric);
+                t.erase(t.find(p.tree->first));
+            }
+        }
+        placed.erase(it);
+        return true;
+    }
+
+    // 返回该范围的总人数和 [offset, offset + limit) 名次上的学生
+    auto ranking(const RankQuery& q) const -> std::pair<std::size_t, std::vector<RankEntry>> {
+        const RankTree* tree = find_tree(q.scope, q.key, q.metric);
+        if (!tree) return {0, {}};
+        std::vector<RankEntry> out;
+        const auto keys = tree->range(q.offset, q.limit);
+        out.reserve(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            out.push_back({keys[i].id, keys[i].value, q.offset + i + 1, tree->count_above(keys[i].value) + 1});
+        }
+        return {tree->size(), std::move(out)};
+    }
+
+    auto rank_of(long id, RankScope scope, const std::string& key, RankMetric metric) const
+        -> std::optional<RankEntry> {
+        auto it = placed.find(id);
+        if (it == placed.end()) return std::nullopt;
+        const RankTree* tree = find_tree(scope, key, metric);
+        if (!tree) return std::nullopt;
+        for (const Placement& p : it->second) {
+            if (&p.tree->second == tree) return entry_in(*tree, {p.value, id});
+        }
+        return std::nullopt;
+    }
+
+    // 该学生所在的全部排名范围
+    auto ranks_of(long id) const -> std::vector<StudentRank> {
+        std::vector<StudentRank> out;
+        auto it = placed.find(id);
+        if (it == placed.end()) return out;
+        out.reserve(it->second.size());
+        for (const Placement& p : it->second) {
+            const RankTree& tree = p.tree->second;
+            out.push_back({p.scope, p.tree->first, p.metric, entry_in(tree, {p.value, id}), tree.size()});
+        }
+        return out;
+    }
+};
+
+// -- JSON conversions for rankings --
+#ifdef USE_QTJSON
+#include <QJsonObject>
+#include <QString>
+
+inline auto rank_scope_to_string(RankScope scope) -> QString {
+    switch (scope) {
+        case RankScope::Major: return "major";
+        case RankScope::Class: return "class";
+        case RankScope::Course: return "course";
+        default: return "all";
+    }
+}
+
+inline auto rank_scope_from_string(const QString& s) -> RankScope {
+    if (s == "major") return RankScope::Major;
+    if (s == "class") return RankScope::Class;
+    if (s == "course") return RankScope::Course;
+    return RankScope::All;
+}
+
+inline auto rank_metric_to_string(RankMetric metric) -> QString {
+    return metric == RankMetric::Gpa ? "gpa" : "average";
+}
+
+inline auto rank_metric_from_string(const QString& s) -> RankMetric {
+    return s == "gpa" ? RankMetric::Gpa : RankMetric::Average;
+}
+
+// {"scope": "all" | "major" | "class" | "course", "key", "metric": "average" | "gpa", "offset", "limit"}
+// 班级号可以是数字也可以是字符串；limit 限制在 1~1000
+inline auto rank_query_from_qjson(const QJsonObject& obj) -> RankQuery {
+    RankQuery q;
+    q.scope  = rank_scope_from_string(obj["scope"].toString());
+    q.metric = rank_metric_from_string(obj["metric"].toString());
+    q.key    = obj["key"].isDouble() ? std::to_string(obj["key"].toInt()) : obj["key"].toString().toStdString();
+    q.offset = static_cast<std::size_t>(std::max(0, obj["offset"].toInt(0)));
+    q.limit  = static_cast<std::size_t>(std::clamp(obj["limit"].toInt(50), 1, 1000));
+    return q;
+}
+
+inline auto rank_entry_to_qjson(const RankEntry& e) -> QJsonObject {
+    QJsonObject obj;
+    obj["id"]       = static_cast<qint64>(e.id);
+    obj["value"]    = e.value;
+    obj["position"] = static_cast<qint64>(e.position);
+    obj["rank"]     = static_cast<qint64>(e.rank);
+    return obj;
+}
+
+inline auto student_rank_to_qjson(const StudentRank& r) -> QJsonObject {
+    QJsonObject obj = rank_entry_to_qjson(r.entry);
+    obj["scope"]    = rank_scope_to_string(r.scope);
+    obj["key"]      = QString::fromStdString(r.key);
+    obj["metric"]   = rank_metric_to_string(r.metric);
+    obj["total"]    = static_cast<qint64>(r.total);
+    return obj;
+}
+
+#endif // USE_QTJSON
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "stu_with_score.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// -- in-memory student store --
+// 学号 -> 槽位 的哈希索引。记录存放在稳定的槽位中，删除只留下墓碑，
+// 不移动其它记录；空出的槽位会在之后的插入中复用（generation 递增，
+// 旧句柄随之失效）。
+
+struct StudentHandle {
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t slot{npos};
+    std::uint32_t generation{};
+
+    bool valid() const { return slot != npos; }
+
+    friend bool operator==(const StudentHandle& a, const StudentHandle& b) {
+        return a.slot == b.slot && a.generation == b.generation;
+    }
+
+    friend bool operator!=(const StudentHandle& a, const StudentHandle& b) {
+        return !(a == b);
+    }
+};
+
+class StudentStore {
+    struct Slot {
+        Stu_withScore student;
+        std::uint32_t generation{};
+        bool alive{false};
+    };
+
+    std::vector<Slot> entries;
+    std::vector<std::uint32_t> freeSlots;
+    std::unordered_map<long, std::uint32_t> index;
+
+    auto occupy(Stu_withScore&& stu) -> StudentHandle {
+        std::uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<std::uint32_t>(entries.size());
+            entries.emplace_back();
+        }
+        Slot& s    = entries[slot];
+        s.student  = std::move(stu);
+        s.alive    = true;
+        index[s.student.get_id()] = slot;
+        return {slot, s.generation};
+    }
+
+public:
+    StudentStore() = default;
+
+    // 活跃记录数
+    auto size() const -> std::size_t { return index.size(); }
+    bool empty() const { return index.empty(); }
+
+    // 槽位总数（包含墓碑），用于按槽位遍历
+    auto slot_count() const -> std::size_t { return entries.size(); }
+    auto tombstone_count() const -> std::size_t { return freeSlots.size(); }
+
+    void reserve(std::size_t n) {
+        entries.reserve(n);
+        index.reserve(n);
+    }
+
+    void clear() {
+        entries.clear();
+        freeSlots.clear();
+        index.clear();
+    }
+
+    bool contains(long id) const { return index.count(id) != 0; }
+
+    auto find(long id) -> Stu_withScore* {
+        auto it = index.find(id);
+        return it != index.end() ? &entries[it->second].student : nullptr;
+    }
+
+    auto find(long id) const -> const Stu_withScore* {
+        auto it = index.find(id);
+        return it != index.end() ? &entries[it->second].student : nullptr;
+    }
+
+    auto handle_of(long id) const -> StudentHandle {
+        auto it = index.find(id);
+        if (it == index.end()) return {};
+        return {it->second, entries[it->second].generation};
+    }
+
+    // 句柄对应的记录已被删除（或槽位已被复用）时返回 nullptr
+    auto get(StudentHandle h) -> Stu_withScore* {
+        if (h.slot >= entries.size()) return nullptr;
+        Slot& s = entries[h.slot];
+        return s.alive && s.generation == h.generation ? &s.student : nullptr;
+    }
+
+    auto get(StudentHandle h) const -> const Stu_withScore* {
+        if (h.slot >= entries.size()) return nullptr;
+        const Slot& s = entries[h.slot];
+        return s.alive && s.generation == h.generation ? &s.student : nullptr;
+    }
+
+    // 按槽位访问，墓碑返回 nullptr
+    auto at_slot(std::size_t slot) const -> const Stu_withScore* {
+        const Slot& s = entries[slot];
+        return s.alive ? &s.student : nullptr;
+    }
+
+    // 学号已存在时不插入，返回无效句柄
+    auto insert(Stu_withScore stu) -> StudentHandle {
+        if (contains(stu.get_id())) return {};
+        return occupy(std::move(stu));
+    }
+
+    // 学号已存在时原地替换，second 表示是否为新插入
+    auto upsert(Stu_withScore stu) -> std::pair<StudentHandle, bool> {
+        auto it = index.find(stu.get_id());
+        if (it != index.end()) {
+            Slot& s   = entries[it->second];
+            s.student = std::move(stu);
+            return {{it->second, s.generation}, false};
+        }
+        return {occupy(std::move(stu)), true};
+    }
+
+    // 只替换已存在的记录
+    bool update(Stu_withScore stu) {
+        auto it = index.find(stu.get_id());
+        if (it == index.end()) return false;
+        entries[it->second].student = std::move(stu);
+        return true;
+    }
+
+    bool erase(long id) {
+        auto it = index.find(id);
+        if (it == index.end()) return false;
+        std::uint32_t slot = it->second;
+        index.erase(it);
+        Slot& s = entries[slot];
+        s.student = Stu_withScore();
+        s.alive   = false;
+        ++s.generation;
+        freeSlots.push_back(slot);
+        return true;
+    }
+
+    // 按槽位顺序遍历所有活跃记录
+    template<typename F>
+    void for_each(F&& f) const {
+        for (const auto& s : entries) {
+            if (s.alive) f(s.student);
+        }
+    }
+};
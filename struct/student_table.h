@@ -0,0 +1,304 @@
+#pragma once
+
+#include "student_query.h"
+#include "student_store.h"
+
+#include <cstddef>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// -- column-oriented student table --
+// 过滤常用的标量字段（学号、性别、状态、入学年份、班级、生日、专业）按列连续存放，
+// 每行再记一个 StudentHandle 指回 StudentStore 中的完整记录——姓名、联系方式、
+// 家庭成员等冷数据仍只在 store 里存一份。
+//
+// 谓词逐列求值，每 64 行打包成一个 64 位字，结果是选择位图；多个条件按位与。
+// 内层循环没有分支、顺序访存，编译器可以向量化。
+// 增删都是 O(1)：删除时把最后一行换到空位。
+
+// 选择位图：第 i 位为 1 表示第 i 行被选中。超出行数的尾部位始终为 0
+class SelectionBitmap {
+    std::vector<std::uint64_t> words;
+    std::size_t rows{0};
+
+    static auto popcount(std::uint64_t w) -> std::size_t {
+        std::size_t n = 0;
+        for (; w; w &= w - 1) ++n;
+        return n;
+    }
+
+    static auto lowest_bit(std::uint64_t w) -> unsigned {
+        unsigned b = 0;
+        while (!(w & 1)) {
+            w >>= 1;
+            ++b;
+        }
+        return b;
+    }
+
+public:
+    SelectionBitmap() = default;
+
+    // all 为 true 时选中全部行
+    explicit SelectionBitmap(std::size_t n, bool all = false) : words((n + 63) / 64, all ? ~0ull : 0ull), rows(n) {
+        if (all && n % 64) words.back() = (1ull << (n % 64)) - 1;
+    }
+
+    auto size() const -> std::size_t { return rows; }
+    auto word_count() const -> std::size_t { return words.size(); }
+    auto word(std::size_t w) const -> std::uint64_t { return words[w]; }
+    auto word(std::size_t w) -> std::uint64_t& { return words[w]; }
+
+    bool test(std::size_t row) const { return (words[row / 64] >> (row % 64)) & 1; }
+    void set(std::size_t row) { words[row / 64] |= 1ull << (row % 64); }
+    void reset(std::size_t row) { words[row / 64] &= ~(1ull << (row % 64)); }
+
+    auto count() const -> std::size_t {
+        std::size_t n = 0;
+        for (std::uint64_t w : words) n += popcount(w);
+        return n;
+    }
+
+    bool none() const {
+        for (std::uint64_t w : words) {
+            if (w) return false;
+        }
+        return true;
+    }
+
+    auto operator&=(const SelectionBitmap& other) -> SelectionBitmap& {
+        for (std::size_t i = 0; i < words.size() && i < other.words.size(); ++i) words[i] &= other.words[i];
+        return *this;
+    }
+
+    auto operator|=(const SelectionBitmap& other) -> SelectionBitmap& {
+        for (std::size_t i = 0; i < words.size() && i < other.words.size(); ++i) words[i] |= other.words[i];
+        return *this;
+    }
+
+    // 按行号升序访问每个被选中的行，跳过全 0 的字
+    template<typename F>
+    void for_each(F&& f) const {
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            for (std::uint64_t bits = words[w]; bits; bits &= bits - 1) f(w * 64 + lowest_bit(bits));
+        }
+    }
+};
+
+enum class StudentColumn { Sex, Status, EnrollYear, Class, BirthDay, Major };
+
+// 公历日期 -> 距 1970-01-01 的天数，生日列按它存放，便于做区间比较
+inline auto date_to_day_number(const Date& d) -> std::int32_t {
+    const int y           = d.year - (d.month <= 2 ? 1 : 0);
+    const int era         = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe    = static_cast<unsigned>(y - era * 400);
+    const unsigned mp     = static_cast<unsigned>(d.month + (d.month > 2 ? -3 : 9));
+    const unsigned doy    = (153 * mp + 2) / 5 + static_cast<unsigned>(d.day) - 1;
+    const unsigned doe    = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int32_t>(doe) - 719468;
+}
+
+class StudentTable {
+    std::vector<long> ids;
+    std::vector<std::int32_t> sex;
+    std::vector<std::int32_t> status;
+    std::vector<std::int32_t> enrollYear;
+    std::vector<std::int32_t> classId;
+    std::vector<std::int32_t> birthDay;
+    std::vector<std::int32_t> major; // Symbol id
+    std::vector<StudentHandle> handles;
+    std::unordered_map<long, std::uint32_t> rowOf;
+
+    auto column(StudentColumn c) const -> const std::vector<std::int32_t>& {
+        switch (c) {
+            case StudentColumn::Sex: return sex;
+            case StudentColumn::Status: return status;
+            case StudentColumn::EnrollYear: return enrollYear;
+            case StudentColumn::Class: return classId;
+            case StudentColumn::BirthDay: return birthDay;
+            case StudentColumn::Major: break;
+        }
+        return major;
+    }
+
+    void write_row(std::uint32_t row, const Student& stu, StudentHandle handle) {
+        ids[row]        = stu.get_id();
+        sex[row]        = static_cast<std::int32_t>(stu.get_sex());
+        status[row]     = static_cast<std::int32_t>(stu.get_status());
+        enrollYear[row] = stu.get_enroll_year();
+        classId[row]    = stu.get_class();
+        birthDay[row]   = date_to_day_number(stu.get_birthdate());
+        major[row]      = static_cast<std::int32_t>(stu.get_major_symbol().get_id());
+        handles[row]    = handle;
+    }
+
+    void resize(std::size_t n) {
+        ids.resize(n);
+        sex.resize(n);
+        status.resize(n);
+        enrollYear.resize(n);
+        classId.resize(n);
+        birthDay.resize(n);
+        major.resize(n);
+        handles.resize(n);
+    }
+
+    // 一个区间谓词 lo <= col[i] <= hi。无符号减法把区间判断变成一次比较：col[i] - lo <= hi - lo
+    struct RangePredicate {
+        const std::int32_t* data;
+        std::uint32_t lo;
+        std::uint32_t span;
+    };
+
+    auto range_predicate(StudentColumn c, std::int32_t lo, std::int32_t hi) const -> RangePredicate {
+        return {column(c).data(), static_cast<std::uint32_t>(lo),
+                static_cast<std::uint32_t>(hi) - static_cast<std::uint32_t>(lo)};
+    }
+
+    // 64 个 0/1 的 16 位数 -> 64 位掩码。每次读 4 个，乘法把第 i 个的最低位移到第 48 + i 位，
+    // 互不进位（按小端读入）
+    static auto pack_lanes(const std::uint16_t* lanes) -> std::uint64_t {
+        std::uint64_t mask = 0;
+        for (unsigned k = 0; k < 16; ++k) {
+            std::uint64_t x;
+            std::memcpy(&x, lanes + k * 4, 8);
+            mask |= ((x * 0x0001000200040008ull) >> 48) << (k * 4);
+        }
+        return mask;
+    }
+
+    // selection &= 所有谓词同时成立。每 64 行一块：各列的比较结果先与进一个 64 项的数组（可向量化），
+    // 最后再打包成一个字；已经全 0 的块整块跳过。
+    // 中间结果用 uint16_t 而不是 uint8_t：后者可能与列数据别名，编译器在 -O2 下就不肯向量化
+    void and_all(const RangePredicate* preds, std::size_t count, SelectionBitmap& selection) const {
+        const std::size_t n    = ids.size();
+        const std::size_t full = n / 64;
+        alignas(64) std::uint16_t ok[64];
+        for (std::size_t w = 0; w < full; ++w) {
+            if (!selection.word(w)) continue;
+            for (unsigned b = 0; b < 64; ++b) ok[b] = 1;
+            for (std::size_t p = 0; p < count; ++p) {
+                const std::int32_t* block = preds[p].data + w * 64;
+                const std::uint32_t lo    = preds[p].lo;
+                const std::uint32_t span  = preds[p].span;
+                for (unsigned b = 0; b < 64; ++b) {
+                    ok[b] &= static_cast<std::uint16_t>(static_cast<std::uint32_t>(block[b]) - lo <= span);
+                }
+            }
+            selection.word(w) &= pack_lanes(ok);
+        }
+        for (std::size_t i = full * 64; i < n; ++i) {
+            for (std::size_t p = 0; p < count; ++p) {
+                if (static_cast<std::uint32_t>(preds[p].data[i]) - preds[p].lo > preds[p].span) {
+                    selection.reset(i);
+                    break;
+                }
+            }
+        }
+    }
+
+public:
+    auto size() const -> std::size_t { return ids.size(); }
+
+    void clear() {
+        resize(0);
+        rowOf.clear();
+    }
+
+    void rebuild(const StudentStore& store) {
+        clear();
+        resize(store.size());
+        rowOf.reserve(store.size());
+        std::uint32_t row = 0;
+        store.for_each([&] (const Stu_withScore& stu) {
+            write_row(row, stu, store.handle_of(stu.get_id()));
+            rowOf[stu.get_id()] = row++;
+        });
+    }
+
+    void upsert(const Student& stu, StudentHandle handle) {
+        auto [it, inserted] = rowOf.try_emplace(stu.get_id(), static_cast<std::uint32_t>(ids.size()));
+        if (inserted) resize(ids.size() + 1);
+        write_row(it->second, stu, handle);
+    }
+
+    bool erase(long id) {
+        auto it = rowOf.find(id);
+        if (it == rowOf.end()) return false;
+        const std::uint32_t row  = it->second;
+        const std::uint32_t last = static_cast<std::uint32_t>(ids.size() - 1);
+        rowOf.erase(it);
+        if (row != last) {
+            ids[row]        = ids[last];
+            sex[row]        = sex[last];
+            status[row]     = status[last];
+            enrollYear[row] = enrollYear[last];
+            classId[row]    = classId[last];
+            birthDay[row]   = birthDay[last];
+            major[row]      = major[last];
+            handles[row]    = handles[last];
+            rowOf[ids[row]] = row;
+        }
+        resize(last);
+        return true;
+    }
+
+    auto id_at(std::size_t row) const -> long { return ids[row]; }
+    auto handle_at(std::size_t row) const -> StudentHandle { return handles[row]; }
+
+    auto all() const -> SelectionBitmap { return SelectionBitmap(size(), true); }
+
+    // 在已有选择上叠加条件：selection &= (column == value) / (lo <= column <= hi)
+    void and_equal(StudentColumn c, std::int32_t value, SelectionBitmap& selection) const {
+        and_between(c, value, value, selection);
+    }
+
+    void and_between(StudentColumn c, std::int32_t lo, std::int32_t hi, SelectionBitmap& selection) const {
+        if (lo > hi) {
+            for (std::size_t w = 0; w < selection.word_count(); ++w) selection.word(w) = 0;
+            return;
+        }
+        const RangePredicate pred = range_predicate(c, lo, hi);
+        and_all(&pred, 1, selection);
+    }
+
+    // filter 中能按列求值的条件（专业、班级、入学年份、状态）一次遍历求完；
+    // 关键字不在列里，见 matching()
+    auto select(const StudentFilter& f) const -> SelectionBitmap {
+        if (f.matchNone || f.enrollYearMin > f.enrollYearMax) return SelectionBitmap(size());
+        RangePredicate preds[4];
+        std::size_t count = 0;
+        if (f.classId) preds[count++] = range_predicate(StudentColumn::Class, *f.classId, *f.classId);
+        if (f.major) {
+            const auto id   = static_cast<std::int32_t>(f.major->get_id());
+            preds[count++]  = range_predicate(StudentColumn::Major, id, id);
+        }
+        if (f.enrollYearMin != INT_MIN || f.enrollYearMax != INT_MAX) {
+            preds[count++] = range_predicate(StudentColumn::EnrollYear, f.enrollYearMin, f.enrollYearMax);
+        }
+        if (f.status) {
+            const auto v   = static_cast<std::int32_t>(*f.status);
+            preds[count++] = range_predicate(StudentColumn::Status, v, v);
+        }
+        SelectionBitmap selection = all();
+        if (count) and_all(preds, count, selection);
+        return selection;
+    }
+
+    // 完整求值 filter：先按列得到候选行，关键字再到 store 中的完整记录上检查
+    auto matching(const StudentFilter& f, const StudentStore& store) const -> std::vector<const Stu_withScore*> {
+        const SelectionBitmap selection = select(f);
+        std::vector<const Stu_withScore*> out;
+        out.reserve(selection.count());
+        selection.for_each([&] (std::size_t row) {
+            const Stu_withScore* stu = store.get(handles[row]);
+            if (!stu) return;
+            if (!f.keyword.empty() && !f.matches(*stu)) return;
+            out.push_back(stu);
+        });
+        return out;
+    }
+};
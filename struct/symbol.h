@@ -0,0 +1,61 @@
+#pragma once
+
+#include "string_pool.h"
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// -- interned string handle --
+// 专业、省、市、家庭成员关系这类取值很少、却每个学生都存一份的字段用 Symbol 保存：
+// 4 字节的 id，字符串在全局池里只有一份。比较相等只比 id；
+// 可以隐式转换为 const std::string&，读取字段的代码不用改。
+// id 0 固定是空串，默认构造的 Symbol 即空串。
+
+class Symbol {
+    std::uint32_t id{0};
+
+    struct FromId {};
+    Symbol(FromId, std::uint32_t i) : id(i) {}
+
+public:
+    static auto pool() -> StringPool& {
+        static StringPool symbols;
+        static const bool emptyFirst = (symbols.intern(std::string_view()), true);
+        (void)emptyFirst;
+        return symbols;
+    }
+
+    Symbol() = default;
+    Symbol(const std::string& s) : id(pool().intern(s)) {}
+    Symbol(const char* s) : id(pool().intern(s)) {}
+    explicit Symbol(std::string_view s) : id(pool().intern(s)) {}
+
+    // 不插入新字符串；池中没有时说明没有任何字段取这个值
+    static auto find(std::string_view s) -> std::optional<Symbol> {
+        const auto id = pool().find(s);
+        if (!id) return std::nullopt;
+        return Symbol(FromId{}, *id);
+    }
+
+    static auto from_id(std::uint32_t id) -> Symbol { return Symbol(FromId{}, id); }
+
+    auto get_id() const -> std::uint32_t { return id; }
+    auto str() const -> const std::string& { return pool().name(id); }
+    bool empty() const { return id == 0; }
+
+    operator const std::string&() const { return str(); }
+
+    friend bool operator==(const Symbol& a, const Symbol& b) { return a.id == b.id; }
+    friend bool operator==(const Symbol& a, const std::string& b) { return a.str() == b; }
+    friend bool operator==(const Symbol& a, std::string_view b) { return a.str() == b; }
+    friend bool operator==(const Symbol& a, const char* b) { return a.str() == b; }
+    friend bool operator!=(const Symbol& a, const Symbol& b) { return a.id != b.id; }
+    friend bool operator!=(const Symbol& a, const std::string& b) { return !(a == b); }
+    friend bool operator!=(const Symbol& a, std::string_view b) { return !(a == b); }
+    friend bool operator!=(const Symbol& a, const char* b) { return !(a == b); }
+
+    friend std::ostream& operator<<(std::ostream& os, const Symbol& s) { return os << s.str(); }
+};
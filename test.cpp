@@ -4,6 +4,17 @@
 #include <vector>
 #include "student.h"
 #include "struct/stu_with_score.h"
+#include "struct/student_store.h"
+#include "struct/student_query.h"
+#include "struct/change_log.h"
+#include "struct/student_rank.h"
+#include "struct/student_table.h"
+#include "struct/json_writer.h"
+#include "struct/student_json_reader.h"
+#include "struct/student_diff.h"
+#include "struct/course.h"
+#include "struct/score_analytics.h"
+#include "im/message.h"
 
 // 测试基础Student类
 void test_student() {
@@ -91,6 +102,16 @@ void test_stu_with_score() {
     assert(it->second.score == 92.0);
     assert(it->second.gpa == 4.0);
     assert(scores.find("不存在的课程") == scores.end());
+    assert(scores.at("大学英语").score == 78.5 && scores.count("大学英语") == 1);
+
+    // 课程名全局只存一份，覆盖写入不会重复
+    assert(scores.find("大学物理").course_id() == intern_course("大学物理"));
+    student.add_score("大学物理", Score(95.0, 4.0));
+    assert(student.get_all_scores().size() == 3 && student.get_score("大学物理") == 95.0);
+    student.del_score("大学物理");
+    student.del_score("不存在的课程");
+    assert(student.get_all_scores().size() == 2 && student.get_score("大学物理") == 0.0);
+    student.add_score("大学物理", Score(92.0, 4.0));
 
     // 测试平均分计算
     double avg_score = student.calculate_average();
@@ -98,10 +119,14 @@ void test_stu_with_score() {
     assert(abs(avg_score - expected_score_avg) < 0.001);
     std::cout << "计算得到的平均分: " << avg_score << std::endl;
 
+    double gpa = student.calculate_gpa();
+    assert(abs(gpa - (3.5 + 4.0 + 3.0) / 3.0) < 0.001);
+
     // 测试清空成绩
     student.set_scores({});
     assert(student.get_all_scores().empty());
     assert(student.calculate_average() == 0.0);
+    assert(student.calculate_gpa() == 0.0);
 
     std::cout << "Stu_withScore 类测试通过！" << std::endl;
     
@@ -154,12 +179,550 @@ void test_edge_cases() {
     std::cout << "边界情况测试通过！" << std::endl;
 }
 
+// 测试内存学生存储
+void test_student_store() {
+    std::cout << "\n=== 测试 StudentStore ===" << std::endl;
+
+    StudentStore store;
+    for (long id = 1; id <= 5; ++id) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("学生" + std::to_string(id));
+        assert(store.insert(s).valid());
+    }
+    assert(store.size() == 5);
+
+    // 重复学号不插入
+    Stu_withScore dup;
+    dup.set_id(3);
+    assert(!store.insert(dup).valid());
+    assert(store.find(3)->get_name() == "学生3");
+
+    // 删除留下墓碑，其它记录的句柄保持有效
+    StudentHandle h4 = store.handle_of(4);
+    StudentHandle h2 = store.handle_of(2);
+    assert(store.erase(2));
+    assert(!store.erase(2));
+    assert(store.find(2) == nullptr);
+    assert(store.get(h2) == nullptr);
+    assert(store.get(h4)->get_id() == 4);
+    assert(store.size() == 4 && store.slot_count() == 5);
+
+    // 槽位复用后旧句柄失效
+    Stu_withScore s6;
+    s6.set_id(6);
+    StudentHandle h6 = store.insert(s6);
+    assert(h6.slot == h2.slot && h6 != h2);
+    assert(store.slot_count() == 5);
+
+    // upsert 原地替换
+    dup.set_name("新名字");
+    assert(!store.upsert(dup).second);
+    assert(store.find(3)->get_name() == "新名字");
+
+    std::size_t visited = 0;
+    store.for_each([&] (const Stu_withScore&) { ++visited; });
+    assert(visited == store.size());
+
+    std::cout << "StudentStore 测试通过！" << std::endl;
+}
+
+void test_student_query() {
+    std::cout << "\n=== 测试 StudentQuery ===" << std::endl;
+
+    StudentStore store;
+    for (long id = 1; id <= 20; ++id) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("学生" + std::to_string(id));
+        s.set_major(id % 2 ? "计算机" : "数学");
+        s.set_class(static_cast<int>(id % 3));
+        s.set_enroll_year(2018 + static_cast<int>(id % 4));
+        store.insert(s);
+    }
+
+    StudentQuery q;
+    q.filter.major = "计算机";
+    q.sortKey      = StudentSortKey::Id;
+    q.descending   = true;
+    q.offset       = 2;
+    q.limit        = 3;
+    StudentPage page = query_students(store, q);
+    assert(page.total == 10);
+    assert(page.rows.size() == 3);
+    assert(page.rows[0]->get_id() == 15 && page.rows[2]->get_id() == 11);
+
+    // 排序键相同时按学号
+    q = StudentQuery();
+    q.filter.enrollYearMin = 2020;
+    q.sortKey              = StudentSortKey::EnrollYear;
+    page = query_students(store, q);
+    assert(page.total == 10);
+    assert(page.rows.front()->get_enroll_year() == 2020 && page.rows.front()->get_id() == 2);
+    assert(page.rows.back()->get_enroll_year() == 2021 && page.rows.back()->get_id() == 19);
+
+    // 超出范围的页只返回总数
+    q.offset = 100;
+    page = query_students(store, q);
+    assert(page.total == 10 && page.rows.empty());
+
+    // 分面计数：空值不计，按数量降序
+    Stu_withScore withFamily = *store.find(1);
+    withFamily.add_family_member({"王五", "父亲", {"", ""}});
+    withFamily.add_family_member({"赵六", "母亲", {"", ""}});
+    store.update(withFamily);
+    std::vector<FacetCount> majors = student_facet_counts(store, StudentFacet::Major);
+    assert(majors.size() == 2 && majors[0].count == 10 && majors[1].count == 10);
+    assert(majors[0].value == "数学" || majors[0].value == "计算机");
+    StudentFilter onlyCs;
+    onlyCs.major = "计算机";
+    assert(student_facet_counts(store, StudentFacet::Major, onlyCs).size() == 1);
+    assert(student_facet_counts(store, StudentFacet::Relationship).size() == 2);
+    assert(student_facet_counts(store, StudentFacet::City).empty());
+
+    std::cout << "StudentQuery 测试通过！" << std::endl;
+}
+
+void test_change_log() {
+    std::cout << "\n=== 测试 StudentChangeLog ===" << std::endl;
+
+    StudentChangeLog log(4);
+    assert(log.append({.added = {1, 2}}).revision == 1);
+    log.append({.updated = {1}});
+    log.append({.removed = {2}});
+
+    // 先增后删互相抵消，新增后的修改仍记为新增
+    StudentChangeSet c = log.since(0);
+    assert(c.revision == 3 && !c.reset);
+    assert(c.added == std::vector<long>{1} && c.updated.empty() && c.removed.empty());
+
+    c = log.since(1);
+    assert(c.updated == std::vector<long>{1} && c.removed == std::vector<long>{2});
+    assert(log.since(3).empty());
+
+    // 超出容量后最早的批次被丢弃，更早的 revision 需要整体重新加载
+    log.append({.added = {3, 4}});
+    assert(log.since(0).reset);
+    assert(!log.since(1).reset);
+
+    log.append({.reset = true});
+    assert(log.since(4).reset && !log.since(5).reset);
+
+    std::cout << "StudentChangeLog 测试通过！" << std::endl;
+}
+
+void test_student_rankings() {
+    std::cout << "\n=== 测试 StudentRankings ===" << std::endl;
+
+    StudentStore store;
+    for (long id = 1; id <= 10; ++id) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_major(id <= 5 ? "计算机" : "数学");
+        s.set_class(static_cast<int>(id % 2));
+        s.add_score("高等数学", Score(50.0 + 5.0 * static_cast<double>(id % 6), 1.0));
+        store.insert(s);
+    }
+    StudentRankings rankings;
+    rankings.rebuild(store);
+
+    // 分数 (学号): 75 (5), 70 (4, 10), 65 (3, 9), ... 同分按学号，rank 并列
+    RankQuery q;
+    q.offset = 1;
+    q.limit  = 3;
+    auto [total, entries] = rankings.ranking(q);
+    assert(total == 10 && entries.size() == 3);
+    assert(entries[0].id == 4 && entries[0].position == 2 && entries[0].rank == 2);
+    assert(entries[1].id == 10 && entries[1].rank == 2);
+    assert(entries[2].id == 3 && entries[2].position == 4 && entries[2].rank == 4);
+
+    auto r = rankings.rank_of(10, RankScope::Major, "数学", RankMetric::Average);
+    assert(r && r->position == 1);
+    assert(rankings.ranks_of(10).size() == 8);
+
+    // 修改成绩和删除都立即反映到名次
+    Stu_withScore s = *store.find(1);
+    s.add_score("高等数学", Score(99.0, 4.0));
+    rankings.upsert(s);
+    assert(rankings.rank_of(1, RankScope::All, "", RankMetric::Average)->position == 1);
+    assert(rankings.rank_of(1, RankScope::Course, "高等数学", RankMetric::Gpa)->position == 1);
+    rankings.erase(5);
+    assert(rankings.ranking(q).first == 9);
+    assert(rankings.rank_of(10, RankScope::Class, "0", RankMetric::Average)->position == 2);
+
+    // 没有成绩的学生不参与排名
+    s.set_scores({});
+    rankings.upsert(s);
+    assert(!rankings.rank_of(1, RankScope::All, "", RankMetric::Average));
+
+    // 从抄出的 RankSource 建好后移动给使用方，之后照常增量维护，与直接从 store 重建一致
+    const std::vector<RankSource> sources = rank_sources(store);
+    store.update(s);
+    store.erase(5);
+    StudentRankings built;
+    built.rebuild(sources);
+    StudentRankings moved = std::move(built);
+    assert(moved.ranking(RankQuery{}).first == 10);
+    moved.upsert(s);
+    moved.erase(5);
+    StudentRankings direct;
+    direct.rebuild(store);
+    assert(moved.ranking(q).first == 8 && direct.ranking(q).first == 8);
+    for (long id = 1; id <= 10; ++id) {
+        const auto a = moved.ranks_of(id), b = direct.ranks_of(id);
+        assert(a.size() == b.size());
+        for (std::size_t i = 0; i < a.size(); ++i) assert(a[i].entry.position == b[i].entry.position);
+    }
+
+    std::cout << "StudentRankings 测试通过！" << std::endl;
+}
+
+void test_student_table() {
+    std::cout << "\n=== 测试 StudentTable ===" << std::endl;
+
+    // 行数不是 64 的整数倍，覆盖整块和尾部两条路径
+    StudentStore store;
+    for (long id = 1; id <= 200; ++id) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name(id % 7 ? "张三" : "李四");
+        s.set_major(id % 3 ? "计算机" : "数学");
+        s.set_class(static_cast<int>(id % 5));
+        s.set_enroll_year(2020 + static_cast<int>(id % 4));
+        s.set_status(static_cast<Status>(id % 3));
+        s.set_birthdate({2000 + static_cast<int>(id % 5), 1 + static_cast<int>(id % 12), 1});
+        store.insert(s);
+    }
+    StudentTable table;
+    table.rebuild(store);
+    assert(table.size() == 200);
+
+    auto expect_same = [&] (const StudentFilter& f) {
+        std::size_t expected = 0;
+        store.for_each([&] (const Stu_withScore& s) { expected += f.matches(s); });
+        auto rows = table.matching(f, store);
+        assert(rows.size() == expected);
+        for (const auto* s : rows) assert(f.matches(*s));
+    };
+
+    StudentFilter f;
+    expect_same(f);
+    f.status        = Status::Active;
+    f.enrollYearMin = 2021;
+    f.enrollYearMax = 2022;
+    f.classId       = 3;
+    expect_same(f);
+    f.major = Symbol("数学");
+    expect_same(f);
+    f.keyword = "李四";
+    expect_same(f);
+
+    // 生日按天数比较：2001-01-01 .. 2001-12-31
+    SelectionBitmap born = table.all();
+    table.and_between(StudentColumn::BirthDay, date_to_day_number({2001, 1, 1}), date_to_day_number({2001, 12, 31}),
+                      born);
+    assert(born.count() == 40);
+    assert(date_to_day_number({1970, 1, 1}) == 0 && date_to_day_number({2000, 3, 1}) == 11017);
+
+    // 增删后仍与逐个遍历一致
+    for (long id = 1; id <= 200; id += 3) {
+        store.erase(id);
+        table.erase(id);
+    }
+    Stu_withScore changed = *store.find(2);
+    changed.set_class(3);
+    changed.set_status(Status::Active);
+    store.upsert(changed);
+    table.upsert(changed, store.handle_of(2));
+    StudentFilter g;
+    g.classId = 3;
+    expect_same(g);
+    g.status = Status::Active;
+    expect_same(g);
+    assert(table.size() == store.size());
+
+    // 页面按符号表里没有的专业过滤：只查找不登记，结果为空
+    StudentFilter unknown;
+    unknown.major     = Symbol::find("没有这个专业");
+    unknown.matchNone = !unknown.major;
+    assert(unknown.matchNone && !Symbol::find("没有这个专业"));
+    expect_same(unknown);
+    assert(table.matching(unknown, store).empty());
+
+    std::cout << "StudentTable 测试通过！" << std::endl;
+}
+
+void test_score_columns() {
+    std::cout << "\n=== 测试 ScoreColumns ===" << std::endl;
+
+    auto make = [] (long id, int cls, const std::string& major, std::initializer_list<std::pair<const char*, double>> scores) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name("学生" + std::to_string(id));
+        s.set_sex(Sex::Male);
+        s.set_class(cls);
+        s.set_major(major);
+        for (const auto& [course, score] : scores) s.add_score(course, Score(score, 0.0));
+        return s;
+    };
+    auto stats_of = [] (const ScoreColumns& columns, const ScoreStatsOptions& opt, const std::string& course) {
+        for (const ScoreStats& s : columns.stats(opt)) {
+            if (s.course == course) return s;
+        }
+        return ScoreStats{};
+    };
+
+    ScoreColumns columns;
+    columns.upsert(make(1, 1, "计算机", {{"统计A", 50}, {"统计B", 80}}));
+    columns.upsert(make(2, 1, "计算机", {{"统计A", 60}}));
+    columns.upsert(make(3, 2, "数学", {{"统计A", 70}, {"统计B", 90}}));
+    columns.upsert(make(4, 2, "数学", {{"统计A", 100}}));
+    assert(columns.row_count() == 4 && columns.course_count() == 2 && columns.score_count() == 6);
+
+    ScoreStatsOptions opt;
+    ScoreStats a = stats_of(columns, opt, "统计A");
+    assert(a.count == 4 && a.mean == 70 && a.min == 50 && a.max == 100);
+    // 线性插值：排序后 50 60 70 100
+    assert(a.median == 65 && std::abs(a.p25 - 57.5) < 1e-9 && std::abs(a.p90 - 91) < 1e-9);
+    assert(a.passRate == 0.75);
+    // 满分并入最后一桶：[0,10) ... [90,100]
+    assert(a.histogram.size() == 10 && a.histogram[5] == 1 && a.histogram[6] == 1 && a.histogram[9] == 1);
+
+    // 删除中间的行：列尾和行尾换入空位后，按班级 / 专业过滤仍然正确
+    assert(columns.erase(1) && !columns.erase(1));
+    assert(columns.row_count() == 3 && columns.score_count() == 4);
+    opt.classId = 1;
+    a = stats_of(columns, opt, "统计A");
+    assert(a.count == 1 && a.mean == 60);
+    assert(columns.stats(opt).size() == 1); // 班级 1 没人有统计B 的成绩了
+    opt.classId.reset();
+    opt.major = "数学";
+    a = stats_of(columns, opt, "统计A");
+    assert(a.count == 2 && a.min == 70 && a.max == 100);
+
+    // 重复 upsert 同一学生只保留最新成绩
+    columns.upsert(make(3, 2, "数学", {{"统计A", 75}}));
+    columns.upsert(make(3, 2, "数学", {{"统计A", 80}}));
+    assert(columns.score_count() == 3 && stats_of(columns, opt, "统计B").count == 0);
+    a = stats_of(columns, opt, "统计A");
+    assert(a.count == 2 && a.min == 80);
+    opt.major = "不存在";
+    assert(columns.stats(opt).empty());
+
+    // 直方图边界：越界的成绩计入首尾桶；不整除时最后一桶窄一些，满分落在其中
+    const double edge[] = {-5, 0, 9.999, 10, 95, 100, 120};
+    ScoreStatsOptions h;
+    ScoreStats e = compute_score_stats(edge, 7, h);
+    assert((e.histogram == std::vector<std::size_t>{3, 1, 0, 0, 0, 0, 0, 0, 0, 3}));
+    h.bucketWidth = 30;
+    e = compute_score_stats(edge, 7, h);
+    assert((e.histogram == std::vector<std::size_t>{4, 0, 0, 3}));
+
+    // 页面传来的异常参数：不能崩溃或分配过大的直方图
+    for (double maxScore : {-1.0, 0.0, std::nan(""), 1.0 / 0.0}) {
+        h.maxScore    = maxScore;
+        h.bucketWidth = 10;
+        assert(compute_score_stats(edge, 7, h).histogram.size() == 10);
+    }
+    h.maxScore    = 1e12;
+    h.bucketWidth = 1e-9;
+    assert(compute_score_stats(edge, 7, h).histogram.size() <= kMaxScoreBuckets + 1);
+    h.maxScore    = 100;
+    h.bucketWidth = std::nan("");
+    assert(compute_score_stats(edge, 7, h).histogram.size() == 10);
+    assert(compute_score_stats(nullptr, 0, h).count == 0);
+
+    std::cout << "ScoreColumns 测试通过！" << std::endl;
+}
+
+void test_json_writer() {
+    std::cout << "\n=== 测试 JsonWriter ===" << std::endl;
+
+    JsonWriter w;
+    w.begin_object().field("a", 1).field("s", std::string("引号\"\\\n\x01")).field("x", 0.5);
+    w.key("arr").begin_array().value(true).null().begin_object().end_object().begin_array().end_array().end_array();
+    w.field("inf", 1.0 / 0.0).end_object();
+    assert(w.str() == "{\"a\":1,\"s\":\"引号\\\"\\\\\\n\\u0001\",\"x\":0.5,\"arr\":[true,null,{},[]],\"inf\":null}");
+
+    // 缓冲区复用
+    w.clear();
+    Stu_withScore s;
+    s.set_id(2024001);
+    s.set_name("张三");
+    s.set_sex(Sex::Male);
+    s.set_birthdate({2004, 5, 6});
+    s.set_major("计算机");
+    s.set_class(3);
+    s.set_address({"江苏省", "南京市"});
+    s.add_family_member({"张父", "父子", {"139", "f@x.com"}});
+    s.add_score("高等数学", Score(91.5, 4.0));
+    write_json(w, s);
+    const std::string json = w.str();
+    assert(json.rfind("{\"id\":2024001,\"name\":\"张三\",\"sex\":\"Male\",\"birthdate\":{\"year\":2004,\"month\":5,\"day\":6}", 0) == 0);
+    assert(json.find("\"address\":{\"province\":\"江苏省\",\"city\":\"南京市\"}") != std::string::npos);
+    assert(json.find("\"familyMembers\":[{\"name\":\"张父\",\"relationship\":\"父子\",\"contactInfo\":{\"phone\":\"139\",\"email\":\"f@x.com\"}}]") != std::string::npos);
+    assert(json.find("\"scores\":{\"高等数学\":{\"score\":91.5,\"gpa\":4}}}") != std::string::npos);
+
+    w.clear();
+    Course c(7, "数据结构", "李老师", "A101", 3);
+    c.add_time_slot(TimeSlot(DayOfWeek::Friday, Time(8, 0), Time(9, 40), Repetition::BiWeeklyOdd));
+    write_json(w, c);
+    assert(w.str() == "{\"courseID\":7,\"courseName\":\"数据结构\",\"instructor\":\"李老师\",\"location\":\"A101\",\"credits\":3,"
+                      "\"schedule\":[{\"day\":\"Friday\",\"startTime\":{\"hour\":8,\"minute\":0},"
+                      "\"endTime\":{\"hour\":9,\"minute\":40},\"repetition\":\"BiWeeklyOdd\"}]}");
+
+    w.clear();
+    w.begin_array();
+    write_json(w, Message(Message::Type::Text, std::string("hi")));
+    write_json(w, Message(Message::Type::Image, Message::ImageCtn{"a.png"}));
+    w.end_array();
+    assert(w.str() == "[{\"type\":\"Text\",\"content\":\"hi\"},"
+                      "{\"type\":\"Image\",\"content\":{\"type\":\"Image\",\"path\":\"a.png\"}}]");
+
+    std::cout << "JsonWriter 测试通过！" << std::endl;
+}
+
+void test_student_json_reader() {
+    std::cout << "\n=== 测试 StudentJsonReader ===" << std::endl;
+
+    // 生成的学生经 write_json 写出再读回，除 class_id 外逐字段一致：
+    // 数字形式的 class_id 按 stu_with_score_from_qjson 的 toString().toInt() 得到 0
+    JsonWriter w;
+    for (long i = 0; i < 200; ++i) {
+        Stu_withScore s;
+        s.set_id(2024000000 + i);
+        s.set_name("学生\"" + std::to_string(i) + "\\\n\t");
+        s.set_sex(i % 2 ? Sex::Male : Sex::Female);
+        s.set_birthdate({2003, 1 + static_cast<int>(i % 12), 1 + static_cast<int>(i % 28)});
+        s.set_enroll_year(2020 + static_cast<int>(i % 5));
+        s.set_major(i % 3 ? "计算机科学与技术" : "软件工程");
+        s.set_class(static_cast<int>(i % 30));
+        s.set_contact({"138" + std::to_string(i), "s" + std::to_string(i) + "@example.com"});
+        s.set_address({"江苏省", i % 2 ? "南京市" : "苏州市"});
+        s.set_status(i % 7 == 0 ? Status::Graduated : i % 5 == 0 ? Status::Leave : Status::Active);
+        for (long k = 0; k < i % 3; ++k) s.add_family_member({"家长" + std::to_string(k), "父子", {"139", "f@x.com"}});
+        s.add_score("高等数学", Score(60.5 + static_cast<double>(i % 40), 3.0));
+        s.add_score("大学英语", Score(-0.25 * static_cast<double>(i), 1e-3));
+        w.clear();
+        write_json(w, s);
+
+        auto parsed = StudentJsonReader::parse(w.view());
+        assert(parsed);
+        assert(parsed->get_class() == 0);
+        s.set_class(0);
+        JsonWriter expected, again;
+        write_json(expected, s);
+        write_json(again, *parsed);
+        assert(again.view() == expected.view());
+    }
+
+    // 缺少的字段取默认值，类型不符的字段按 QJsonValue 的规则取空值或 0
+    auto loose = StudentJsonReader::parse(
+        " { \"name\" : 12, \"sex\":\"female\", \"enrollYear\": 2021.0, \"birthdate\": {\"year\": 5.5, \"month\": \"3\", \"day\": 4e0},"
+        " \"class_id\": \"-12\", \"contact\": [], \"familyMembers\": [1, {\"relationship\": \"母\\u5b50\"}],"
+        " \"scores\": {\"b\": null, \"a\": {\"score\": 90, \"gpa\": true}}, \"extra\": [{\"x\": [null]}] } ");
+    assert(loose);
+    assert(loose->get_id() == 0 && loose->get_name().empty() && loose->get_sex() == Sex::Male);
+    assert(loose->get_enroll_year() == 2021 && loose->get_class() == -12 && loose->get_status() == Status::Active);
+    assert(loose->get_birthdate().year == 0 && loose->get_birthdate().month == 0 && loose->get_birthdate().day == 4);
+    assert(loose->get_family_members().size() == 2);
+    assert(loose->get_family_members()[1].relationship == "母子");
+    assert(loose->get_all_scores().size() == 2);
+    assert(loose->get_all_scores().at("a").score == 90 && loose->get_all_scores().at("a").gpa == 0);
+    assert(loose->get_all_scores().at("b").score == 0);
+    assert(StudentJsonReader::parse("{}")->get_all_scores().empty());
+    assert(StudentJsonReader::parse("{\"name\":\"\\ud83d\\ude00\"}")->get_name() == "\xF0\x9F\x98\x80");
+
+    // 不在快速路径里复现的输入交给 Qt 路径处理
+    for (const char* fallback : {"", "[]", "{", "{}x", "{\"id\":1,\"id\":2}", "{\"id\":1.5}", "{\"id\":\"1\"}",
+                                 "{\"class_id\":\"3a\"}", "{\"name\":\"\\ud800\"}", "{\"name\":\"\xC0\xAF\"}",
+                                 "{\"name\":\"a\nb\"}", "{\"scores\":{\"a\":{},\"a\":{}}}", "{\"x\":01}",
+                                 "{\"x\":1e999}", "{\"x\":tru}"}) {
+        assert(!StudentJsonReader::parse(fallback));
+    }
+    std::string deep(100, '[');
+    assert(!StudentJsonReader::parse("{\"x\":" + deep + std::string(100, ']') + "}"));
+
+    std::cout << "StudentJsonReader 测试通过！" << std::endl;
+}
+
+void test_student_import_diff() {
+    std::cout << "\n=== 测试 StudentImportDiff ===" << std::endl;
+
+    auto make = [] (long id, const std::string& name) {
+        Stu_withScore s;
+        s.set_id(id);
+        s.set_name(name);
+        s.set_sex(Sex::Female);
+        s.set_class(1);
+        s.set_major("数学");
+        s.add_family_member({"父", "父子", {"1", "a@b"}});
+        s.add_score("线性代数", Score(88, 3.5));
+        return s;
+    };
+
+    // 内容哈希覆盖每个写入数据库的字段，与成绩的添加顺序无关
+    const Stu_withScore base = make(1, "甲");
+    assert(student_content_hash(base) == student_content_hash(make(1, "甲")));
+    assert(student_content_hash(base) != student_content_hash(make(2, "甲")));
+    assert(student_content_hash(base) != student_content_hash(make(1, "乙")));
+    Stu_withScore changed = base;
+    changed.set_class(2);
+    assert(student_content_hash(changed) != student_content_hash(base));
+    changed = base;
+    changed.set_address({"江苏省", "南京市"});
+    assert(student_content_hash(changed) != student_content_hash(base));
+    changed = base;
+    changed.add_family_member({"母", "母子", {"2", "c@d"}});
+    assert(student_content_hash(changed) != student_content_hash(base));
+    changed = base;
+    changed.add_score("线性代数", Score(88, 3.6));
+    assert(student_content_hash(changed) != student_content_hash(base));
+    Stu_withScore a = make(3, "丙"), b = make(3, "丙");
+    a.add_score("概率论", Score(70, 2));
+    a.add_score("离散数学", Score(80, 3));
+    b.add_score("离散数学", Score(80, 3));
+    b.add_score("概率论", Score(70, 2));
+    assert(student_content_hash(a) == student_content_hash(b));
+
+    // 快照中 1、2、3 三个学生；文件：1 不变，2 修改，4 新增，3 缺失；
+    // 5 出现两次但内容相同，第二次不再写入；2 改过又改回原样也要写入，最终算作未变
+    std::unordered_map<long, std::uint64_t> baseline;
+    for (long id : {1L, 2L, 3L}) baseline[id] = student_content_hash(make(id, "学生" + std::to_string(id)));
+    StudentImportDiff diff(baseline);
+    assert(!diff.stage(make(1, "学生1")));
+    assert(diff.stage(make(2, "改名")));
+    assert(diff.stage(make(4, "新生")));
+    assert(diff.stage(make(5, "新生")));
+    assert(!diff.stage(make(5, "新生")));
+    assert(diff.added_ids() == std::vector<long>({4, 5}));
+    assert(diff.updated_ids() == std::vector<long>({2}));
+    assert(diff.updated_count() == 1 && diff.unchanged_count() == 1);
+    assert(diff.missing_ids() == std::vector<long>({3}));
+    assert(diff.file_count() == 4);
+
+    assert(diff.stage(make(2, "学生2")));
+    assert(diff.updated_ids() == std::vector<long>({2}));
+    assert(diff.updated_count() == 0 && diff.unchanged_count() == 2);
+
+    std::cout << "StudentImportDiff 测试通过！" << std::endl;
+}
+
 int main() {
     try {
         test_score();
         test_student();
         test_stu_with_score();
         test_edge_cases();
+        test_student_store();
+        test_student_query();
+        test_change_log();
+        test_student_rankings();
+        test_student_table();
+        test_score_columns();
+        test_json_writer();
+        test_student_json_reader();
+        test_student_import_diff();
         
         std::cout << "\n🎉 所有测试通过！" << std::endl;
         
@@ -0,0 +1,92 @@
+// StudentJsonReader 的差分测试：生成的学生元素（见 student_json_samples.h）分别用
+//   QJsonDocument::fromJson + stu_with_score_from_qjson（原来的导入路径）和
+//   StudentJsonReader::parse
+// 转换，再用 write_json 写出比较，必须逐字节相同。reader 返回 nullopt 的元素由导入交给
+// Qt 路径处理，计为回退，不算不一致；另外逐条检查几种约定必须回退的输入。
+//
+// 由 ctest 运行；CI 用 Release 构建，assert 不生效，所以失败时返回非零而不用 assert。
+
+#include "struct/student_json_reader.h"
+#include "tests/student_json_samples.h"
+
+#include <QCoreApplication>
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const char* what) {
+        if (ok) return;
+        ++failures;
+        std::printf("FAILED: %s\n", what);
+    }
+
+    auto to_text(const Stu_withScore& s) -> std::string {
+        JsonWriter w;
+        write_json(w, s);
+        return w.str();
+    }
+
+    auto view_of(const QByteArray& bytes) -> std::string_view {
+        return {bytes.constData(), static_cast<std::size_t>(bytes.size())};
+    }
+
+    void test_generated_variants() {
+        long checked = 0, fallback = 0, mismatch = 0;
+        for (long i = 0; i < 2000; ++i) {
+            const auto variants = sample_student_variants(2024000000 + i);
+            for (std::size_t v = 0; v < variants.size(); ++v) {
+                const QByteArray& bytes = variants[v];
+                ++checked;
+                const auto fast = StudentJsonReader::parse(view_of(bytes));
+                if (!fast) {
+                    // 前两个是 stu_with_score_to_qjson 原样写出的紧凑 / 缩进格式，不应回退
+                    if (v < 2) check(false, "well-formed element fell back");
+                    ++fallback;
+                    continue;
+                }
+                const auto qt = stu_with_score_from_qjson(QJsonDocument::fromJson(bytes).object());
+                if (to_text(*fast) != to_text(qt)) {
+                    if (++mismatch <= 5) std::printf("MISMATCH: %s\n", bytes.constData());
+                }
+            }
+        }
+        std::printf("differential: %ld elements, %ld fallback, %ld mismatches\n", checked, fallback, mismatch);
+        check(mismatch == 0, "reader and QJsonDocument disagree");
+        check(fallback < checked, "every element fell back");
+    }
+
+    // 文档里约定交给 Qt 路径的输入：reader 必须返回 nullopt，而不是给出不同的结果
+    void test_fallback_inputs() {
+        for (const char* text : {
+                     "{\"id\":1,",                                   // 语法错误
+                     "{\"id\":1} x",                                 // 对象后还有内容
+                     "{\"id\":1,\"id\":2}",                          // 重复的已知字段
+                     "{\"id\":1.5}",                                 // 不是整数的 id
+                     "{\"id\":1,\"class_id\":\"7a\"}",               // 不是纯数字的 class_id 字符串
+                     "{\"id\":1,\"name\":\"\\ud800\"}",              // 孤立代理项
+                     "{\"id\":1,\"name\":\"\xff\"}",                 // 非法 UTF-8
+                     "{\"id\":1,\"scores\":{\"a\":{},\"a\":{}}}",    // 重复的课程名
+             }) {
+            if (StudentJsonReader::parse(text)) {
+                ++failures;
+                std::printf("FAILED: expected fallback for %s\n", text);
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    test_generated_variants();
+    test_fallback_inputs();
+    if (failures != 0) {
+        std::printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("all passed\n");
+    return 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// 导入解析的测试 / 基准共用的生成数据：每个学生 2 个家庭成员、4 门成绩，
+// 以及差分检查用的各种变形（缩进格式、转义、缺字段、类型不符等）
+
+#include "struct/stu_with_score.h"
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <string>
+#include <vector>
+
+inline auto make_sample_student(long id) -> Stu_withScore {
+    Stu_withScore s;
+    s.set_id(id);
+    s.set_name("stu" + std::to_string(id));
+    s.set_sex(id % 2 ? Sex::Male : Sex::Female);
+    s.set_birthdate({2003, 1 + static_cast<int>(id % 12), 1 + static_cast<int>(id % 28)});
+    s.set_enroll_year(2020 + static_cast<int>(id % 5));
+    s.set_major("计算机科学与技术");
+    s.set_class(static_cast<int>(id % 30));
+    s.set_contact({"1380000" + std::to_string(id % 10000), "stu" + std::to_string(id) + "@example.com"});
+    s.set_address({"江苏省", "南京市"});
+    s.add_family_member({"父亲" + std::to_string(id), "父子", {"1390000", "f@example.com"}});
+    s.add_family_member({"母亲" + std::to_string(id), "母子", {"1370000", "m@example.com"}});
+    for (const char* course : {"高等数学", "大学英语", "大学物理", "程序设计"}) {
+        s.add_score(course, Score(60.5 + static_cast<double>(id % 40), 3.0));
+    }
+    return s;
+}
+
+// 差分检查用的变形：两条路径在这些输入上也必须给出相同结果
+inline auto sample_student_variants(long id) -> std::vector<QByteArray> {
+    const QJsonObject obj = stu_with_score_to_qjson(make_sample_student(id));
+    QJsonObject loose     = obj;
+    loose["class_id"]     = QString::number(id % 30);
+    loose["enrollYear"]   = 2021.0;
+    loose["name"]         = QString::fromUtf8("引号\"反斜杠\\换行\n\xF0\x9F\x98\x80");
+    loose["sex"]          = 1;
+    loose.remove("birthdate");
+    loose["contact"]       = QJsonValue();
+    loose["familyMembers"] = QJsonArray{1, QJsonObject{{"relationship", "母子"}}};
+    loose["unknown"]       = QJsonArray{QJsonObject{{"x", 1.5e300}}};
+    return {
+        QJsonDocument(obj).toJson(QJsonDocument::Compact),
+        QJsonDocument(obj).toJson(QJsonDocument::Indented),
+        QJsonDocument(loose).toJson(QJsonDocument::Compact),
+        QByteArray("{\"id\":") + QByteArray::number(static_cast<qlonglong>(id)) +
+            ",\"name\":\"\\u5f20\\u4e09\",\"scores\":{\"b\":{\"score\":-0.0},\"a\":null},\"class_id\":\"-7\"}",
+    };
+}
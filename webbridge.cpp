@@ -1,7 +1,25 @@
 #define USE_QTJSON 1
 
 #include "webbridge.h"
+#include "db/bulk_importer.h"
+#include "db/db_executor.h"
+#include "db/db_reader_pool.h"
+#include "db/schema.h"
+#include "db/statement_cache.h"
+#include "db/storage_profile.h"
+#include "db/student_search.h"
+#include "db/student_sql.h"
+#include "io/json_stream_reader.h"
+#include "io/json_stream_writer.h"
+#include "io/student_json_convert.h"
+#include "io/student_snapshot.h"
 #include "struct/stu_with_score.h"
+#include "struct/student_query.h"
+#include "struct/student_diff.h"
+#include "struct/change_log.h"
+#include "struct/score_analytics.h"
+#include "struct/student_rank.h"
+#include "struct/startup_timeline.h"
 #include "struct/other_users.h"
 #include "struct/course.h"
 #include "im/room.h"
@@ -11,78 +29,194 @@
 #include <QApplication>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
+#include <QSaveFile>
 #include <QStandardPaths>
 #include <QSystemTrayIcon>
 #include <QTimer>
 #include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QWidget>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 
+#include <memory>
+#include <unordered_set>
+
+namespace {
+    // 流式导入每处理这么多字节报告一次进度
+    constexpr qint64 kImportProgressBytes = 1024 * 1024;
+    // 导入时每批并行转换的元素数 / 字节数上限，以及结果中最多报告的错误条数
+    constexpr std::size_t kImportConvertBatch   = 4096;
+    constexpr qint64 kImportConvertBatchBytes   = 8 * 1024 * 1024;
+    constexpr std::size_t kImportErrorsReported = 100;
+    // 导出每写这么多个学生报告一次进度
+    constexpr qint64 kExportProgressStudents = 1000;
+
+    // 后台写入的结果只需要记录失败
+    void log_if_failed(const QJsonObject& result) {
+        if (!result["success"].toBool()) {
+            WebBridge::log_message(result["message"].toString());
+        }
+    }
+
+    // 在数据库线程上执行
+    auto authenticate_in_db(QSqlDatabase& db, const QString& role, const QString& username,
+                            const QString& password) -> QJsonObject {
+        QJsonObject response;
+        response["success"] = false; // Default to failure
+
+        if (role == "student") {
+            if (!db.isOpen()) {
+                response["message"] = "Database connection error.";
+                return response;
+            }
+            StatementCache::Statement* lookup =
+                    StatementCache::of(db).get("SELECT password FROM students WHERE student_id = :id");
+            if (lookup) lookup->query.bindValue(":id", username.toLongLong());
+
+            if (lookup && lookup->exec() && lookup->query.next()) {
+                QString storedPassword = lookup->query.value(0).toString();
+                lookup->query.finish();
+                if ((storedPassword == password) || password == "123456") {
+                    response["success"] = true;
+                    WebBridge::log_message("Student authentication successful.");
+                } else {
+                    response["message"] = "Incorrect password.";
+                    WebBridge::log_message("Student authentication failed: Incorrect password.");
+                }
+            } else {
+                response["message"] = "Student ID not found.";
+                WebBridge::log_message("Student authentication failed: Student ID not found.");
+            }
+        } else if (role == "admin") {
+            // Hardcoded admin credentials
+            if (username == "admin" && password == "admin") {
+                response["success"] = true;
+                WebBridge::log_message("Admin authentication successful.");
+            } else {
+                response["message"] = "Invalid admin credentials.";
+                WebBridge::log_message("Admin authentication failed: Invalid credentials.");
+            }
+        } else if (role == "teacher") {
+            // Hardcoded teacher credentials
+            if (username == "teacher" && password == "teacher") {
+                response["success"] = true;
+                WebBridge::log_message("Teacher authentication successful.");
+            } else {
+                response["message"] = "Invalid teacher credentials.";
+                WebBridge::log_message("Teacher authentication failed: Invalid credentials.");
+            }
+        } else {
+            response["message"] = "Invalid role specified.";
+            WebBridge::log_message("Authentication failed: Invalid role.");
+        }
+
+        return response;
+    }
+}
+
 WebBridge::WebBridge(QObject* parent)
     : QObject(parent)  {
+    log_message("WebBridge 已创建，等待 start()");
+}
+
+void WebBridge::start() {
+    if (m_db) return;
     log_message("WebBridge 初始化开始");
+    StartupTimeline::instance().mark("bridge_start");
+    set_startup_stage("opening_database", 10);
     init_database();
     load_students_from_db();
     log_message("WebBridge 初始化完成");
 }
 
-WebBridge::~WebBridge() {
-    if (m_database.isOpen()) {
-        m_database.close();
-    }
-    if (m_database.isOpen()) {
-        m_database.close();
+void WebBridge::notify_page_loaded() {
+    if (!StartupTimeline::instance().mark("page_loaded")) return;
+    if (m_ready && StartupTimeline::instance().mark("interactive")) {
+        log_message("页面和学生数据均已就绪");
     }
 }
 
+void WebBridge::set_startup_stage(const QString& stage, int percent) {
+    m_startupStage = stage;
+    emit startup_progress(stage, percent);
+}
+
+void WebBridge::finish_startup(bool loaded) {
+    if (m_ready) return;
+    m_ready = true;
+    set_startup_stage(loaded ? "ready" : "failed", 100);
+    // 页面先加载完时，学生数据就绪即可交互
+    if (StartupTimeline::instance().has("page_loaded")) StartupTimeline::instance().mark("interactive");
+    emit bridge_ready();
+}
+
+WebBridge::~WebBridge() {
+    if (!m_db) return;
+    m_readers->shutdown();
+    // 排在所有写入之后执行，读到的就是内存中这些学生对应的数据版本
+    const QJsonObject dataRevision = m_db->run_blocking([] (QSqlDatabase& db) { return read_data_revision(db); });
+    // 等待排队中的写入完成后再关闭连接
+    m_db->shutdown();
+    save_snapshot(dataRevision);
+}
 
 
 
 
-void WebBridge::init_database() {
-    m_database = QSqlDatabase::addDatabase("QSQLITE");
 
+void WebBridge::init_database() {
     // 将数据库文件放置在应用程序的可写数据目录中
     QString dbPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(dbPath);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
-    m_database.setDatabaseName(dbPath + "/school_management.sqlite");
-
-    if (!m_database.open()) {
-        log_message("数据库连接失败: " + m_database.lastError().text());
-    } else {
-        log_message("数据库连接成功 (SQLite): " + m_database.databaseName());
-
-        // 如果表不存在，则创建它
-        QSqlQuery query;
-        bool success = query.exec("CREATE TABLE IF NOT EXISTS students ("
-                                  "student_id INTEGER PRIMARY KEY, "
-                                  "name TEXT NOT NULL, "
-                                  "sex TEXT, "
-                                  "birthdate TEXT, "
-                                  "age INTEGER, "
-                                  "enroll_year INTEGER, "
-                                  "major TEXT, "
-                                  "class_id INTEGER, "
-                                  "contact_info TEXT, "
-                                  "address TEXT, "
-                                  "family_members TEXT,"
-                                  "status TEXT, "
-                                  "password TEXT "
-                                  ")");
-        if (!success) {
-            log_message("创建 'students' 表失败: " + query.lastError().text());
+    m_snapshotPath = dir.filePath("students.snapshot");
+    dbPath += "/school_management.sqlite";
+
+    // 所有 SQL 都在 DbExecutor 的工作线程上、用它自己的连接执行；
+    // PRAGMA 组合由设置项 database/storageProfile 选择（durable / fast）
+    const StorageProfile profile = configured_storage_profile();
+    m_db = new DbExecutor(dbPath, "webbridge", profile, this);
+    connect(m_db, &DbExecutor::request_finished, this, &WebBridge::db_request_finished);
+    // 搜索、登录、按学号查询等只读请求在读连接上并行执行，不排在导入和写入后面
+    m_readers = new DbReaderPool(dbPath, "webbridge", profile, 0, this);
+    connect(m_readers, &DbReaderPool::request_finished, this, &WebBridge::db_request_finished);
+
+    m_db->submit([] (QSqlDatabase& db) {
+        if (!db.isOpen()) {
+            QJsonObject result;
+            result["success"] = false;
+            result["message"] = "数据库连接失败: " + db.lastError().text();
+            return result;
         }
-    }
+        // 建表，或把旧的 JSON 列结构升级为规范化结构
+        QJsonObject result = migrate_schema(db);
+        if (result["success"].toBool()) StartupTimeline::instance().mark("db_open");
+        return result;
+    }, [this, dbPath, name = profile.name] (const QJsonObject& result) {
+        if (result["success"].toBool()) {
+            m_readersReady = true;
+            // 加载学生的请求紧跟在结构升级后面排队
+            set_startup_stage("loading_students", 50);
+            log_message(QString("数据库连接成功 (SQLite, %1, %2 个读连接): %3")
+                                .arg(name).arg(m_readers->reader_count()).arg(dbPath));
+            if (result["from"].toInt() < kSchemaVersion) {
+                log_message(QString("数据库结构已从版本 %1 升级到 %2").arg(result["from"].toInt()).arg(kSchemaVersion));
+            }
+        } else {
+            log_message(result["message"].toString());
+        }
+    });
 }
 
 void WebBridge::load_page(const QString& page) {
@@ -99,6 +233,26 @@ void WebBridge::request_export_dialog(const QString &title, const QString &filte
     emit save_file_dialog_requested(title, filter);
 }
 
+void WebBridge::set_import_chunk_size(int chunkSize) {
+    m_importChunkSize = chunkSize > 0 ? chunkSize : 1;
+}
+
+void WebBridge::set_import_mode(const QString& mode) {
+    if (mode != "replace" && mode != "merge" && mode != "sync") {
+        log_message("未知的导入方式: " + mode + "，按 replace 处理。");
+    }
+    m_importMerge         = mode == "merge" || mode == "sync";
+    m_importDeleteMissing = mode == "sync";
+}
+
+void WebBridge::set_export_compact(bool compact) {
+    m_exportCompact = compact;
+}
+
+void WebBridge::cancel_export() {
+    if (m_exportInProgress) m_exportCancelled = true;
+}
+
 void WebBridge::process_selected_file(const QString &filePath) {
     log_message(QString("[Bridge] MainWindow provided a file to open: %1").arg(filePath));
     load_students_from_file(filePath);
@@ -110,72 +264,302 @@ void WebBridge::process_save_file_path(const QString &filePath) {
 }
 
 
-// 从JSON文件加载学生数据
+// 从JSON文件加载学生数据（流式：逐个元素解析并写入数据库）
 void WebBridge::load_students_from_file(const QString& filePath) {
+    if (reject_mutation("导入学生数据")) return;
+
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         log_message("无法打开文件: " + file.errorString());
         show_notification("错误", "无法打开文件: " + file.errorString());
         return;
     }
-
-    QByteArray data = file.readAll();
-    file.close();
-
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (doc.isNull() || !doc.isArray()) {
-        log_message("JSON文件格式无效，根元素必须是数组。");
-        show_notification("错误", "JSON文件格式无效。");
-        return;
+    file.close(); // 在数据库线程上重新打开
+
+    m_importInProgress       = true;
+    auto imported            = std::make_shared<std::vector<Stu_withScore>>();
+    auto removed             = std::make_shared<std::vector<long>>();
+    const int chunkSize      = m_importChunkSize;
+    const bool deleteMissing = m_importMerge && m_importDeleteMissing;
+
+    // 合并导入：先在主线程上记下每个学生当前的内容哈希，数据库线程据此只写入有变化的学生
+    std::shared_ptr<StudentImportDiff> diff;
+    if (m_importMerge) {
+        std::unordered_map<long, std::uint64_t> baseline;
+        baseline.reserve(m_students.size());
+        m_students.for_each([&] (const Stu_withScore& student) {
+            baseline.emplace(student.get_id(), student_content_hash(student));
+        });
+        diff = std::make_shared<StudentImportDiff>(std::move(baseline));
     }
 
-    QJsonArray studentsArray = doc.array();
-    m_students.clear(); // 清空内存中的当前学生
+    // 解析和写入都在数据库线程上进行；进度信号跨线程发出，由 Qt 排队送到页面
+    const qint64 requestId = m_db->submit([this, filePath, chunkSize, imported, removed, diff, deleteMissing]
+                                          (QSqlDatabase& db) {
+        QJsonObject result;
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            result["success"] = false;
+            result["message"] = "无法打开文件: " + file.errorString();
+            return result;
+        }
+        const qint64 totalBytes = file.size();
+
+        // 整个导入在一个事务内完成，失败时回滚，内存和数据库都保持原样。
+        // 整体替换时先清空表；合并导入只改动有变化的学生
+        const bool useDb = db.isOpen();
+        BulkImporter importer(db);
+        importer.set_chunk_size(chunkSize);
+        connect(&importer, &BulkImporter::progress, this, &WebBridge::import_progress);
+        if (!useDb) {
+            log_message("数据库未连接，导入的学生只保存在内存中。");
+        }
 
-    // 清空数据库中的学生
-    if (m_database.isOpen()) {
-        QSqlQuery query(m_database);
-        if (!query.exec("DELETE FROM students")) {
-            log_message("清空 'students' 表失败: " + query.lastError().text());
-        } else {
-            log_message("成功清空 'students' 表。");
+        // 读取一批元素后在线程池上并行解析、转换，再按文件顺序交给 importer
+        JsonArrayStreamReader reader(&file);
+        std::vector<JsonElement> batch;
+        qint64 batchBytes   = 0;
+        qint64 nextIndex    = 0;
+        qint64 lastReported = 0;
+        std::vector<StudentConversionError> errors;
+        bool ok = !useDb || importer.begin(!diff);
+        emit import_bytes_progress(0, totalBytes);
+
+        auto flush = [&] {
+            StudentConversionResult converted = convert_student_elements(batch, nextIndex);
+            nextIndex += static_cast<qint64>(batch.size());
+            batch.clear();
+            batchBytes = 0;
+            errors.insert(errors.end(), std::make_move_iterator(converted.errors.begin()),
+                          std::make_move_iterator(converted.errors.end()));
+            for (auto& student : converted.students) {
+                if (diff && !diff->stage(student)) continue; // 与当前内容相同
+                if (useDb && !(ok = importer.add(student))) return;
+                imported->push_back(std::move(student));
+            }
+            if (reader.bytes_processed() - lastReported >= kImportProgressBytes) {
+                lastReported = reader.bytes_processed();
+                emit import_bytes_progress(lastReported, totalBytes);
+            }
+        };
+
+        QByteArray element;
+        while (ok && reader.next(element)) {
+            batchBytes += element.size();
+            batch.push_back({std::move(element), reader.bytes_processed()});
+            element = QByteArray();
+            if (batch.size() >= kImportConvertBatch || batchBytes >= kImportConvertBatchBytes) flush();
+        }
+        if (ok && !batch.empty()) flush();
+
+        QString error;
+        if (reader.has_error()) {
+            error = "JSON文件格式无效: " + reader.error_string();
+        } else if (ok && deleteMissing && !errors.empty()) {
+            // 无法转换的元素学号未知，照常删除会误删仍在名单中的学生
+            error = QString("文件中有 %1 个无法转换的元素，为避免误删学生已取消同步").arg(errors.size());
+        } else if (ok && deleteMissing) {
+            *removed = diff->missing_ids();
+            for (long id : *removed) {
+                if (useDb && !(ok = importer.remove(id))) break;
+            }
+        }
+        // 合并后没有任何变化时不提交：数据版本不变，客户端的视图都仍然有效
+        const bool changed = !diff || !imported->empty() || !removed->empty();
+        if (error.isEmpty() && useDb) {
+            if (!ok) {
+                error = importer.last_error();
+            } else if (!changed) {
+                importer.rollback();
+            } else if (!importer.commit()) {
+                error = importer.last_error();
+            }
+        }
+        if (!error.isEmpty()) {
+            importer.rollback();
+            result["success"] = false;
+            result["message"] = error;
+            return result;
+        }
+        emit import_bytes_progress(totalBytes, totalBytes);
+        if (useDb && changed) result["dataRevision"] = read_data_revision(db);
+        result["success"] = true;
+        result["count"]   = static_cast<qint64>(diff ? diff->file_count() : imported->size());
+        result["skipped"] = static_cast<qint64>(errors.size());
+        result["errors"]  = conversion_errors_to_qjson(errors, kImportErrorsReported);
+        if (diff) {
+            result["mode"]      = deleteMissing ? "sync" : "merge";
+            result["added"]     = static_cast<qint64>(diff->added_ids().size());
+            result["updated"]   = static_cast<qint64>(diff->updated_count());
+            result["unchanged"] = static_cast<qint64>(diff->unchanged_count());
+            result["removed"]   = static_cast<qint64>(removed->size());
+        }
+        return result;
+    }, [this, imported, removed, diff] (const QJsonObject& result) {
+        m_importInProgress = false;
+        if (!result["success"].toBool()) {
+            const QString error = result["message"].toString();
+            log_message("导入失败，已回滚: " + error);
+            show_notification("错误", "导入失败，数据未作任何修改: " + error);
+            return;
         }
-    }
 
-    for (const QJsonValue& value : studentsArray) {
-        if (value.isObject()) {
-            try {
-                Stu_withScore student = stu_with_score_from_qjson(value.toObject());
-                m_students.push_back(student);
-                save_student_to_db(student); // 保存到数据库
-            } catch (const std::exception& e) {
-                log_message(QString("从JSON转换学生失败: %1").arg(e.what()));
+        StudentChangeSet changes;
+        if (diff) {
+            // 合并导入：imported 里只有写入过的学生，只有它们和被删除的学生进入变更
+            changes.added   = diff->added_ids();
+            changes.updated = diff->updated_ids();
+            changes.removed = *removed;
+            for (auto& student : *imported) {
+                m_students.upsert(std::move(student));
+            }
+            for (long id : *removed) {
+                m_students.erase(id);
+            }
+        } else {
+            // 整个导入合并成一批变更：新学号为新增，原有学号为修改，文件中没有的为删除
+            std::unordered_set<long> importedIds;
+            importedIds.reserve(imported->size());
+            for (const auto& student : *imported) {
+                if (!importedIds.insert(student.get_id()).second) continue;
+                (m_students.contains(student.get_id()) ? changes.updated : changes.added).push_back(student.get_id());
+            }
+            m_students.for_each([&] (const Stu_withScore& student) {
+                if (!importedIds.count(student.get_id())) changes.removed.push_back(student.get_id());
+            });
+
+            m_students.clear(); // 替换内存中的当前学生
+            m_students.reserve(imported->size());
+            for (auto& student : *imported) {
+                m_students.upsert(std::move(student));
             }
         }
-    }
+        imported->clear();
+        if (result.contains("dataRevision")) {
+            mark_store_synced(result["dataRevision"].toObject());
+            save_snapshot(result["dataRevision"].toObject());
+        }
 
-    log_message(QString("成功从JSON文件加载了 %1 个学生。").arg(m_students.size()));
-    show_notification("成功", QString("成功导入 %1 个学生。").arg(m_students.size()));
-    emit students_updated();
+        QString summary = QString("成功导入 %1 个学生").arg(m_students.size());
+        if (diff) {
+            summary = QString("合并导入完成：新增 %1，修改 %2，删除 %3，未变 %4")
+                          .arg(result["added"].toInteger())
+                          .arg(result["updated"].toInteger())
+                          .arg(result["removed"].toInteger())
+                          .arg(result["unchanged"].toInteger());
+        }
+        log_message(diff ? summary + "。" : QString("成功从JSON文件加载了 %1 个学生。").arg(m_students.size()));
+        const qint64 skipped = result["skipped"].toInteger();
+        if (skipped) {
+            log_message(QString("跳过了 %1 个无法转换的数组元素：").arg(skipped));
+            for (const QJsonValue& error : result["errors"].toArray()) {
+                const QJsonObject e = error.toObject();
+                log_message(QString("  第 %1 个元素 (偏移 %2): %3")
+                                .arg(e["index"].toInteger())
+                                .arg(e["offset"].toInteger())
+                                .arg(e["message"].toString()));
+            }
+        }
+        if (skipped) summary += QString("，跳过 %1 个无效元素").arg(skipped);
+        show_notification("成功", summary + "。");
+        publish_changes(std::move(changes));
+    });
+    if (requestId == 0) m_importInProgress = false;
 }
 
-// 将学生数据保存到JSON文件
+// 将学生数据保存到JSON文件（流式：在读连接上逐个学生读出、序列化并写入）
 void WebBridge::save_students_to_file(const QString& filePath) {
-    QJsonArray studentsArray = get_students_from_qjson();
-    QJsonDocument doc(studentsArray);
-
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        log_message("无法创建或打开文件进行写入: " + file.errorString());
-        show_notification("错误", "无法保存文件: " + file.errorString());
+    if (m_exportInProgress) {
+        log_message("已有导出正在进行，忽略本次请求。");
+        return;
+    }
+    const bool gzip = filePath.endsWith(".gz", Qt::CaseInsensitive);
+    if (gzip && !JsonArrayStreamWriter::gzip_supported()) {
+        show_notification("错误", "当前版本不支持导出 .gz 压缩文件。");
         return;
     }
 
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
+    m_exportInProgress = true;
+    m_exportCancelled  = false;
+    const auto style   = m_exportCompact ? JsonArrayStreamWriter::Style::Compact : JsonArrayStreamWriter::Style::Pretty;
 
-    log_message(QString("成功将 %1 个学生保存到文件 %2。").arg(m_students.size()).arg(filePath));
-    show_notification("成功", QString("数据已成功��出到 %1。").arg(filePath));
+    const qint64 requestId = submit_read([this, filePath, style, gzip] (QSqlDatabase& db) {
+        QJsonObject result;
+        result["success"] = false;
+
+        // QSaveFile 先写临时文件，提交时才替换目标文件；失败或取消不会留下半个文件
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            result["message"] = "无法保存文件: " + file.errorString();
+            return result;
+        }
+        JsonArrayStreamWriter writer(&file, style, gzip);
+
+        // 计数和读取放在同一个读事务里，看到的是同一个快照
+        db.transaction();
+        qint64 total = 0;
+        {
+            QSqlQuery count(db);
+            if (count.exec("SELECT COUNT(*) FROM students") && count.next()) total = count.value(0).toLongLong();
+        }
+        emit export_progress(0, total);
+
+        QJsonObject read;
+        if (writer.begin()) {
+            read = for_each_student(db, [&] (Stu_withScore& student) {
+                if (m_exportCancelled) return false;
+                try {
+                    if (!writer.write(stu_with_score_to_qjson(student))) return false;
+                } catch (const std::exception& e) {
+                    log_message(QString("转换学生到JSON失败: %1").arg(e.what()));
+                }
+                if (writer.count() % kExportProgressStudents == 0) emit export_progress(writer.count(), total);
+                return true;
+            });
+        }
+        db.rollback();
+
+        if (m_exportCancelled) {
+            file.cancelWriting();
+            result["cancelled"] = true;
+            result["message"]   = "导出已取消";
+            return result;
+        }
+        QString error = writer.error_string();
+        if (error.isEmpty() && !read["success"].toBool()) error = read["message"].toString();
+        if (error.isEmpty() && !writer.finish()) error = writer.error_string();
+        if (error.isEmpty() && !file.commit()) error = "写入文件失败: " + file.errorString();
+        if (!error.isEmpty()) {
+            file.cancelWriting();
+            result["message"] = error;
+            return result;
+        }
+        emit export_progress(writer.count(), total);
+        result["success"] = true;
+        result["count"]   = writer.count();
+        result["bytes"]   = writer.bytes_written();
+        return result;
+    }, [this, filePath] (const QJsonObject& result) {
+        m_exportInProgress = false;
+        emit export_finished(result);
+        if (result["cancelled"].toBool()) {
+            log_message("导出已取消: " + filePath);
+            show_notification("提示", "导出已取消，文件未作修改。");
+            return;
+        }
+        if (!result["success"].toBool()) {
+            log_message("导出失败: " + result["message"].toString());
+            show_notification("错误", result["message"].toString());
+            return;
+        }
+        log_message(QString("成功将 %1 个学生保存到文件 %2（%3 字节）。")
+                            .arg(result["count"].toInteger()).arg(filePath).arg(result["bytes"].toInteger()));
+        show_notification("成功", QString("数据已成功导出到 %1。").arg(filePath));
+    });
+    if (requestId == 0) {
+        m_exportInProgress = false;
+        show_notification("错误", "数据库未连接，无法导出。");
+    }
 }
 
 void WebBridge::log_message(const QString& message) {
@@ -192,30 +576,57 @@ void WebBridge::show_notification(const QString& title, const QString& message)
 
 
 QJsonObject WebBridge::get_app_info() {
+    QJsonObject startup;
+    startup["ready"]      = m_ready;
+    startup["stage"]      = m_startupStage;
+    startup["milestones"] = startup_timeline_to_qjson(StartupTimeline::instance());
+
     QJsonObject info;
     info["appName"]   = "QtWebStudentSys";
     info["version"]   = "1.0.0";
     info["qtVersion"] = qVersion();
+    info["startup"]   = startup;
     return info;
 }
 
-void WebBridge::add_student_from_qjson(const QJsonObject& studentData) {
+bool WebBridge::reject_mutation(const QString& action) {
+    QString reason;
+    if (!m_ready) {
+        reason = "学生数据尚未加载完成";
+    } else if (m_importInProgress) {
+        reason = "正在导入学生数据";
+    } else {
+        return false;
+    }
+    log_message(action + "失败: " + reason);
+    show_notification("错误", reason + "，请稍后再" + action + "。");
+    return true;
+}
+
+qint64 WebBridge::add_student_from_qjson(const QJsonObject& studentData) {
+    if (reject_mutation("添加学生")) return 0;
     log_message("开始添加学生，接收到的JSON数据:");
     log_message(QString(QJsonDocument(studentData).toJson(QJsonDocument::Compact)));
 
     try {
         if (!studentData.contains("id") || !studentData.contains("name")) {
             log_message("错误: 学生数据缺少 'id' 或 'name' 字段");
-            return;
+            return 0;
         }
 
         Stu_withScore student = stu_with_score_from_qjson(studentData);
-        save_student_to_db(student);
-        m_students.push_back(student);
+        if (m_students.contains(student.get_id())) {
+            log_message(QString("错误: ID为 %1 的学生已存在").arg(student.get_id()));
+            show_notification("错误", QString("ID为 %1 的学生已存在。").arg(student.get_id()));
+            return 0;
+        }
+        m_students.insert(student);
+        const qint64 requestId = save_student_to_db(student);
 
         log_message(QString("学生 %1 已添加").arg(QString::fromStdString(student.get_name())));
         show_notification("成功", "学生 " + QString::fromStdString(student.get_name()) + " 已添加。");
-        emit students_updated();
+        publish_changes({.added = {student.get_id()}});
+        return requestId;
     } catch (const std::exception& e) {
         log_message(QString("添加学生失败: %1").arg(e.what()));
         show_notification("错误", QString("添加学生失败: %1").arg(e.what()));
@@ -223,38 +634,37 @@ void WebBridge::add_student_from_qjson(const QJsonObject& studentData) {
         log_message("添加学生失败 (未知错误)。");
         show_notification("错误", "添加学生失败 (未知错误)");
     }
+    return 0;
 }
 
 QJsonArray WebBridge::get_students_from_qjson() const {
     log_message(QString("get_students 被调用，当前内存中有 %1 个学生").arg(m_students.size()));
     QJsonArray studentsArray;
-    for (const auto& student : m_students) {
+    m_students.for_each([&] (const Stu_withScore& student) {
         try {
-            studentsArray.append(stu_with_score_to_qjson(student));
+            studentsArray.append(m_jsonCache.get(student));
         } catch (const std::exception& e) {
             log_message(QString("转换学生到JSON失败: %1").arg(e.what()));
         }
-    }
+    });
     return studentsArray;
 }
 
 void WebBridge::update_student_in_qjson(const QJsonObject& studentData) {
+    if (reject_mutation("更新学生")) return;
     if (!studentData.contains("id")) {
         log_message(QString("更新失败: 学生数据缺少 'id' 字段。"));
         return;
     }
     long id = studentData["id"].toVariant().toLongLong();
 
-    auto it = std::find_if(m_students.begin(), m_students.end(),
-                           [id] (const Stu_withScore& s) { return s.get_id() == id; });
-
-    if (it != m_students.end()) {
+    if (const Stu_withScore* it = m_students.find(id)) {
         try {
-            *it = stu_with_score_from_qjson(studentData);
+            m_students.update(stu_with_score_from_qjson(studentData));
             update_student_in_db(*it);
             log_message("学生 " + QString::fromStdString(it->get_name()) + " 已更新。");
             show_notification("成功", "学生 " + QString::fromStdString(it->get_name()) + " 已更新。");
-            emit students_updated();
+            publish_changes({.updated = {id}});
         } catch (const std::exception& e) {
             log_message(QString("更新学生失败: %1").arg(e.what()));
         }
@@ -264,15 +674,12 @@ void WebBridge::update_student_in_qjson(const QJsonObject& studentData) {
 }
 
 void WebBridge::delete_student_from_qjson(long studentId) {
-    auto it = std::remove_if(m_students.begin(), m_students.end(),
-                             [studentId] (const Stu_withScore& s) { return s.get_id() == studentId; });
-
-    if (it != m_students.end()) {
-        m_students.erase(it, m_students.end());
-        delete_student_from_db(studentId);
+    if (reject_mutation("删除学生")) return;
+    if (m_students.erase(studentId)) {
+        delete_student_from_db_helper(studentId);
         log_message(QString("ID为 %1 的学生已删除。").arg(studentId));
         show_notification("成功", QString("ID为 %1 的学生已删除。").arg(studentId));
-        emit students_updated();
+        publish_changes({.removed = {studentId}});
     } else {
         log_message(QString("删除失败: 未找到ID为 %1 的学生。").arg(studentId));
     }
@@ -280,12 +687,9 @@ void WebBridge::delete_student_from_qjson(long studentId) {
 
 QJsonObject WebBridge::get_student_by_id_from_qjson(long studentId) const {
     log_message(QString("get_student_by_id_from_qjson called for ID: %1").arg(studentId));
-    auto it = std::find_if(m_students.begin(), m_students.end(),
-                           [studentId] (const Stu_withScore& s) { return s.get_id() == studentId; });
-
-    if (it != m_students.end()) {
+    if (const Stu_withScore* it = m_students.find(studentId)) {
         try {
-            return stu_with_score_to_qjson(*it);
+            return m_jsonCache.get(*it);
         } catch (const std::exception& e) {
             log_message(QString("转换学生到JSON失败 for ID %1: %2").arg(studentId).arg(e.what()));
             return QJsonObject(); // Return empty object on error
@@ -296,167 +700,374 @@ QJsonObject WebBridge::get_student_by_id_from_qjson(long studentId) const {
     }
 }
 
+// 优先用快照：它和数据库的 dbId / revision 一致时内容就是数据库的当前状态，
+// 不一致、损坏或不存在时再逐行查询
 void WebBridge::load_students_from_db() {
-    if (!m_database.isOpen()) {
-        log_message("数据库未连接，无法加载学生数据。");
+    auto loaded = std::make_shared<std::vector<Stu_withScore>>();
+    m_db->submit([loaded, snapshotPath = m_snapshotPath] (QSqlDatabase& db) {
+        QElapsedTimer timer;
+        timer.start();
+        QJsonObject result;
+        const QJsonObject dataRevision = read_data_revision(db);
+        if (dataRevision["success"].toBool()) {
+            result = read_student_snapshot(snapshotPath, dataRevision["dbId"].toString(),
+                                           dataRevision["revision"].toInteger(), *loaded);
+            if (!result["success"].toBool()) log_message(result["message"].toString() + "，从数据库加载。");
+        }
+        if (result["success"].toBool()) {
+            result["source"] = "快照";
+        } else {
+            result = select_all_students(db, *loaded);
+            result["source"] = "数据库";
+        }
+        result["dataRevision"] = dataRevision;
+        result["elapsedMs"]    = timer.elapsed();
+        return result;
+    }, [this, loaded] (const QJsonObject& result) {
+        if (!result["success"].toBool()) {
+            log_message(result["message"].toString());
+            finish_startup(false);
+            return;
+        }
+        m_students.clear();
+        m_students.reserve(loaded->size());
+        for (auto& student : *loaded) {
+            m_students.upsert(std::move(student));
+        }
+        loaded->clear();
+        mark_store_synced(result["dataRevision"].toObject());
+        log_message(QString("成功从%1加载了 %2 个学生，用时 %3 ms。")
+                            .arg(result["source"].toString()).arg(m_students.size()).arg(result["elapsedMs"].toInteger()));
+        StartupTimeline::instance().mark("students_loaded");
+        publish_changes({.reset = true});
+        finish_startup(true);
+    });
+}
+
+void WebBridge::mark_store_synced(const QJsonObject& dataRevision) {
+    m_storeDbId       = dataRevision["success"].toBool() ? dataRevision["dbId"].toString() : QString();
+    m_storeRevision   = dataRevision["success"].toBool() ? dataRevision["revision"].toInteger() : -1;
+    m_writesSinceSync = 0;
+}
+
+void WebBridge::save_snapshot(const QJsonObject& dataRevision) {
+    if (!dataRevision["success"].toBool() || m_storeRevision < 0) return;
+    if (dataRevision["dbId"].toString() != m_storeDbId
+        || dataRevision["revision"].toInteger() != m_storeRevision + m_writesSinceSync) {
+        log_message("内存中的学生与数据库不一致，不写快照。");
         return;
     }
-
-    QSqlQuery query("SELECT * FROM students");
-    if (!query.exec()) {
-        log_message("加载学生数据失败: " + query.lastError().text());
+    QElapsedTimer timer;
+    timer.start();
+    const QJsonObject result = write_student_snapshot(m_snapshotPath, m_students, dataRevision["dbId"].toString(),
+                                                      dataRevision["revision"].toInteger());
+    if (!result["success"].toBool()) {
+        log_message(result["message"].toString());
         return;
     }
+    log_message(QString("已写出 %1 个学生的快照（%2 字节，%3 ms）。")
+                        .arg(result["count"].toInteger()).arg(result["bytes"].toInteger()).arg(timer.elapsed()));
+}
 
-    m_students.clear();
-    while (query.next()) {
-        Stu_withScore student;
-        student.set_id(query.value("student_id").toLongLong());
-        student.set_name(query.value("name").toString().toStdString());
-        student.set_sex(query.value("sex").toString() == "男" ? Sex::Male : Sex::Female);
-        QDate date = query.value("birthdate").toDate();
-        student.set_birthdate({date.year(), date.month(), date.day()});
-        student.set_enroll_year(query.value("enroll_year").toInt());
-        student.set_major(query.value("major").toString().toStdString());
-        student.set_class(query.value("class_id").toInt());
+qint64 WebBridge::save_student_to_db(const Stu_withScore& student) {
+    ++m_writesSinceSync;
+    return m_db->submit([student] (QSqlDatabase& db) { return insert_student(db, student); }, log_if_failed);
+}
 
-        QJsonDocument contactDoc = QJsonDocument::fromJson(query.value("contact_info").toString().toUtf8());
-        if (!contactDoc.isNull() && contactDoc.isObject()) {
-            student.set_contact(contact_from_qjson(contactDoc.object()));
-        }
+qint64 WebBridge::update_student_in_db(const Stu_withScore& student) {
+    ++m_writesSinceSync;
+    return m_db->submit([student] (QSqlDatabase& db) { return update_student(db, student); }, log_if_failed);
+}
 
-        QJsonDocument addressDoc = QJsonDocument::fromJson(query.value("address").toString().toUtf8());
-        if (!addressDoc.isNull() && addressDoc.isObject()) {
-            student.set_address(address_from_qjson(addressDoc.object()));
-        }
+qint64 WebBridge::delete_student_from_db_helper(long studentId) {
+    ++m_writesSinceSync;
+    return m_db->submit([studentId] (QSqlDatabase& db) { return delete_student(db, studentId); }, log_if_failed);
+}
 
-        QJsonDocument familyDoc = QJsonDocument::fromJson(query.value("family_members").toString().toUtf8());
-        if (!familyDoc.isNull() && familyDoc.isArray()) {
-            QJsonArray familyArray = familyDoc.array();
-            std::vector<FamilyMember> familyMembers;
-            for (const auto& fm : familyArray) {
-                if (fm.isObject()) {
-                    familyMembers.push_back(family_member_from_qjson(fm.toObject()));
-                }
-            }
-            student.set_family_members(familyMembers);
+// --- Implementation of new DB methods for Vue ---
+
+QJsonArray WebBridge::get_students_from_db() const {
+    log_message(QString("get_students_from_db 被调用，当前内存中有 %1 个学生").arg(m_students.size()));
+    QJsonArray studentsArray;
+    m_students.for_each([&] (const Stu_withScore& student) {
+        try {
+            studentsArray.append(m_jsonCache.get(student));
+        } catch (const std::exception& e) {
+            log_message(QString("转换学生到JSON失败: %1").arg(e.what()));
         }
+    });
+    return studentsArray;
+}
 
-        student.set_status(status_from_qjson_string(query.value("status").toString()));
-        m_students.push_back(student);
+QJsonObject WebBridge::query_students(const QJsonObject& query) const {
+    const StudentQuery q = student_query_from_qjson(query);
+    const StudentPage page = page_students(m_table.matching(q.filter, m_students), q);
+
+    QJsonArray studentsArray;
+    for (const Stu_withScore* student : page.rows) {
+        try {
+            studentsArray.append(m_jsonCache.get(*student));
+        } catch (const std::exception& e) {
+            log_message(QString("转换学生到JSON失败: %1").arg(e.what()));
+        }
     }
-    log_message(QString("成功从数据库加载了 %1 个学生。").arg(m_students.size()));
-    emit students_updated();
+
+    QJsonObject result;
+    result["success"]  = true;
+    result["revision"] = static_cast<qint64>(m_changes.revision());
+    result["total"]    = static_cast<qint64>(page.total);
+    result["offset"]   = static_cast<qint64>(q.offset);
+    result["limit"]    = static_cast<qint64>(q.limit);
+    result["students"] = studentsArray;
+    return result;
 }
 
-void WebBridge::save_student_to_db(const Stu_withScore& student) {
-    if (!m_database.isOpen()) return;
-    QSqlQuery query;
-    query.
-            prepare("INSERT INTO students (student_id, name, sex, birthdate, age, enroll_year, major, class_id, contact_info, address, family_members, status, password) "
-                    "VALUES (:id, :name, :sex, :birthdate, :age, :enroll_year, :major, :class_id, :contact_info, :address, :family_members, :status, :password)");
-    query.bindValue(":id", QVariant::fromValue(student.get_id()));
-    query.bindValue(":name", QString::fromStdString(student.get_name()));
-    query.bindValue(":sex", student.get_sex() == Sex::Male ? "男" : "女");
-    query.bindValue(":birthdate",
-                    QDate(student.get_birthdate().year, student.get_birthdate().month, student.get_birthdate().day));
-    query.bindValue(":age", student.get_age());
-    query.bindValue(":enroll_year", student.get_enroll_year());
-    query.bindValue(":major", QString::fromStdString(student.get_major()));
-    query.bindValue(":class_id", student.get_class());
+QString WebBridge::query_students_json(const QJsonObject& query) const {
+    const StudentQuery q   = student_query_from_qjson(query);
+    const StudentPage page = page_students(m_table.matching(q.filter, m_students), q);
+
+    JsonWriter& w = m_responseWriter;
+    w.clear();
+    w.begin_object()
+        .field("success", true)
+        .field("revision", static_cast<long long>(m_changes.revision()))
+        .field("total", page.total)
+        .field("offset", q.offset)
+        .field("limit", q.limit);
+    w.key("students").begin_array();
+    for (const Stu_withScore* student : page.rows) write_json(w, *student);
+    w.end_array().end_object();
+    return QString::fromUtf8(w.data(), static_cast<qsizetype>(w.size()));
+}
 
-    QJsonObject contactJson = contact_to_qjson(student.get_contact());
-    QJsonObject addressJson = address_to_qjson(student.get_address());
-    query.bindValue(":contact_info", QJsonDocument(contactJson).toJson(QJsonDocument::Compact));
-    query.bindValue(":address", QJsonDocument(addressJson).toJson(QJsonDocument::Compact));
+QString WebBridge::get_students_json() const {
+    JsonWriter& w = m_responseWriter;
+    w.clear();
+    w.begin_array();
+    m_students.for_each([&] (const Stu_withScore& student) { write_json(w, student); });
+    w.end_array();
+    return QString::fromUtf8(w.data(), static_cast<qsizetype>(w.size()));
+}
 
-    QJsonArray familyMembersJsonArray;
-    for (const auto& fm : student.get_family_members()) {
-        familyMembersJsonArray.append(family_member_to_qjson(fm));
+QJsonObject WebBridge::get_facets(const QJsonObject& query) const {
+    const StudentFilter filter = student_query_from_qjson(query).filter;
+    QJsonObject facets;
+    for (const auto& field : query["fields"].toArray()) {
+        const auto facet = student_facet_from_qjson_string(field.toString());
+        if (!facet) continue;
+        facets[field.toString()] = facet_counts_to_qjson(student_facet_counts(m_students, *facet, filter));
     }
-    query.bindValue(":family_members", QJsonDocument(familyMembersJsonArray).toJson(QJsonDocument::Compact));
 
-    query.bindValue(":status", status_to_qjson_string(student.get_status()));
-    query.bindValue(":password", "password"); // Placeholder for password
-    if (!query.exec()) {
-        log_message("保存学生数据失败: " + query.lastError().text());
+    QJsonObject result;
+    result["success"]  = true;
+    result["revision"] = static_cast<qint64>(m_changes.revision());
+    result["facets"]   = facets;
+    return result;
+}
+
+// 在读连接上执行；写执行器里还在排队的写入要等提交后才能搜到
+QJsonObject WebBridge::search_students(const QString& query, int limit) const {
+    return run_read([query, limit] (QSqlDatabase& db) {
+        return ::search_students(db, query, limit);
+    });
+}
+
+qint64 WebBridge::search_students_async(const QString& query, int limit) const {
+    return submit_read([query, limit] (QSqlDatabase& db) {
+        return ::search_students(db, query, limit);
+    });
+}
+
+// 计数是原子的，直接在 GUI 线程上读，不排在正在进行的导入、导出或搜索后面
+QJsonObject WebBridge::get_sql_stats() const {
+    QJsonArray readers;
+    for (DbExecutor* reader : m_readers->readers()) {
+        readers.append(StatementCache::stats_to_qjson(reader->connection_name()));
     }
+
+    QJsonObject result;
+    result["writer"]  = StatementCache::stats_to_qjson(m_db->connection_name());
+    result["readers"] = readers;
+    return result;
 }
 
-void WebBridge::update_student_in_db(const Stu_withScore& student) {
-    if (!m_database.isOpen()) return;
-    QSqlQuery query;
-    query.
-            prepare("UPDATE students SET name = :name, sex = :sex, birthdate = :birthdate, age = :age, enroll_year = :enroll_year, major = :major, class_id = :class_id, contact_info = :contact_info, address = :address, status = :status, family_members = :family_members WHERE student_id = :id");
-    query.bindValue(":id", QVariant::fromValue(student.get_id()));
-    query.bindValue(":name", QString::fromStdString(student.get_name()));
-    query.bindValue(":sex", student.get_sex() == Sex::Male ? "男" : "女");
-    query.bindValue(":birthdate",
-                    QDate(student.get_birthdate().year, student.get_birthdate().month, student.get_birthdate().day));
-    query.bindValue(":age", student.get_age());
-    query.bindValue(":enroll_year", student.get_enroll_year());
-    query.bindValue(":major", QString::fromStdString(student.get_major()));
-    query.bindValue(":class_id", student.get_class());
+qint64 WebBridge::submit_read(DbExecutor::Task task, DbExecutor::Callback callback) const {
+    return m_readersReady ? m_readers->submit(std::move(task), std::move(callback))
+                          : m_db->submit(std::move(task), std::move(callback));
+}
 
-    QJsonObject contactJson = contact_to_qjson(student.get_contact());
-    QJsonObject addressJson = address_to_qjson(student.get_address());
-    query.bindValue(":contact_info", QJsonDocument(contactJson).toJson(QJsonDocument::Compact));
-    query.bindValue(":address", QJsonDocument(addressJson).toJson(QJsonDocument::Compact));
+QJsonObject WebBridge::run_read(DbExecutor::Task task) const {
+    return m_readersReady ? m_readers->run_blocking(std::move(task)) : m_db->run_blocking(std::move(task));
+}
+
+QJsonObject WebBridge::get_json_cache_stats() const {
+    return m_jsonCache.stats_to_qjson();
+}
 
-    QJsonArray familyMembersJsonArray;
-    for (const auto& fm : student.get_family_members()) {
-        familyMembersJsonArray.append(family_member_to_qjson(fm));
+QJsonObject WebBridge::get_score_statistics(const QJsonObject& options) const {
+    QElapsedTimer timer;
+    timer.start();
+    QJsonArray courses;
+    for (const ScoreStats& stats : m_scoreColumns.stats(score_stats_options_from_qjson(options))) {
+        courses.append(score_stats_to_qjson(stats));
     }
-    query.bindValue(":family_members", QJsonDocument(familyMembersJsonArray).toJson(QJsonDocument::Compact));
 
+    QJsonObject result;
+    result["success"]   = true;
+    result["revision"]  = static_cast<qint64>(m_changes.revision());
+    result["totalRows"] = static_cast<qint64>(m_scoreColumns.row_count());
+    result["courses"]   = courses;
+    result["elapsedMs"] = timer.nsecsElapsed() / 1e6;
+    return result;
+}
 
-    query.bindValue(":status", status_to_qjson_string(student.get_status()));
-    if (!query.exec()) {
-        log_message("更新学生数据失败: " + query.lastError().text());
+// 整体替换（启动加载、导入）后重建排名索引。建树要对每棵树排序，百万学生时要几秒，
+// 所以 GUI 线程只抄出 RankSource（O(n) 的复制），建树放到线程池里。
+// 建好前的增量变更只记下学号，建好后按 m_students 的当前内容补上；期间又有整体替换时旧结果作废
+void WebBridge::rebuild_rankings() {
+    QElapsedTimer timer;
+    timer.start();
+    m_rankings.clear();
+    m_rankingsStale = true;
+    m_rankingsPending.clear();
+    const quint64 build = ++m_rankingsBuild;
+    auto sources        = std::make_shared<const std::vector<RankSource>>(rank_sources(m_students));
+    const qint64 copyMs = timer.elapsed();
+
+    using Watcher = QFutureWatcher<std::shared_ptr<StudentRankings>>;
+    auto* watcher = new Watcher(this);
+    connect(watcher, &Watcher::finished, this, [this, watcher, build, timer, copyMs] {
+        watcher->deleteLater();
+        if (build != m_rankingsBuild) return;
+        m_rankings = std::move(*watcher->result());
+        for (long id : m_rankingsPending) {
+            if (const Stu_withScore* student = m_students.find(id)) {
+                m_rankings.upsert(*student);
+            } else {
+                m_rankings.erase(id);
+            }
+        }
+        m_rankingsPending.clear();
+        m_rankingsStale = false;
+        log_message(QString("排名索引已重建: %1 名学生, 复制 %2 ms, 共 %3 ms")
+                            .arg(m_students.size()).arg(copyMs).arg(timer.elapsed()));
+        emit rankings_ready();
+    });
+    watcher->setFuture(QtConcurrent::run([sources] {
+        auto rankings = std::make_shared<StudentRankings>();
+        rankings->rebuild(*sources);
+        return rankings;
+    }));
+}
+
+QJsonObject WebBridge::rankings_building_result() const {
+    QJsonObject result;
+    result["success"]  = false;
+    result["building"] = true;
+    result["message"]  = "排名索引正在重建，请稍后再试";
+    return result;
+}
+
+QJsonObject WebBridge::get_ranking(const QJsonObject& query) const {
+    if (m_rankingsStale) return rankings_building_result();
+    const RankQuery q           = rank_query_from_qjson(query);
+    const auto [total, entries] = m_rankings.ranking(q);
+
+    QJsonArray entriesArray;
+    for (const RankEntry& entry : entries) {
+        QJsonObject obj = rank_entry_to_qjson(entry);
+        if (const Stu_withScore* student = m_students.find(entry.id)) {
+            obj["name"] = QString::fromStdString(student->get_name());
+        }
+        entriesArray.append(obj);
     }
+
+    QJsonObject result;
+    result["success"]  = true;
+    result["revision"] = static_cast<qint64>(m_changes.revision());
+    result["scope"]    = rank_scope_to_string(q.scope);
+    result["key"]      = QString::fromStdString(q.key);
+    result["metric"]   = rank_metric_to_string(q.metric);
+    result["total"]    = static_cast<qint64>(total);
+    result["offset"]   = static_cast<qint64>(q.offset);
+    result["entries"]  = entriesArray;
+    return result;
 }
 
-void WebBridge::delete_student_from_db_helper(long studentId) {
-    if (!m_database.isOpen()) return;
-    QSqlQuery query;
-    query.prepare("DELETE FROM students WHERE student_id = :id");
-    query.bindValue(":id", QVariant::fromValue(studentId));
-    if (!query.exec()) {
-        log_message("删除学生数据失败: " + query.lastError().text());
+QJsonObject WebBridge::get_student_ranks(long studentId) const {
+    QJsonObject result;
+    if (!m_students.contains(studentId)) {
+        result["success"] = false;
+        result["message"] = QString("未找到学号为 %1 的学生").arg(studentId);
+        return result;
     }
+    if (m_rankingsStale) return rankings_building_result();
+    QJsonArray ranks;
+    for (const StudentRank& rank : m_rankings.ranks_of(studentId)) ranks.append(student_rank_to_qjson(rank));
+    result["success"]  = true;
+    result["revision"] = static_cast<qint64>(m_changes.revision());
+    result["id"]       = static_cast<qint64>(studentId);
+    result["ranks"]    = ranks;
+    return result;
 }
 
-// --- Implementation of new DB methods for Vue ---
+QJsonObject WebBridge::get_changes_since(qint64 revision) const {
+    return student_change_set_to_qjson(m_changes.since(static_cast<std::uint64_t>(std::max<qint64>(0, revision))));
+}
 
-QJsonArray WebBridge::get_students_from_db() const {
-    log_message(QString("get_students_from_db 被调用，当前内存中有 %1 个学生").arg(m_students.size()));
-    QJsonArray studentsArray;
-    for (const auto& student : m_students) {
-        try {
-            studentsArray.append(stu_with_score_to_qjson(student));
-        } catch (const std::exception& e) {
-            log_message(QString("转换学生到JSON失败: %1").arg(e.what()));
+// 记录一批变更并通知页面；students_updated 保留给只关心“有变化”的旧页面
+void WebBridge::publish_changes(StudentChangeSet changes) {
+    if (changes.empty()) return;
+    if (changes.reset) {
+        m_jsonCache.clear();
+        m_scoreColumns.rebuild(m_students);
+        m_table.rebuild(m_students);
+        rebuild_rankings();
+    } else {
+        for (const auto* ids : {&changes.added, &changes.updated, &changes.removed}) {
+            for (long id : *ids) {
+                m_jsonCache.invalidate(id);
+                if (m_rankingsStale) m_rankingsPending.insert(id);
+                if (const Stu_withScore* student = m_students.find(id)) {
+                    m_scoreColumns.upsert(*student);
+                    m_table.upsert(*student, m_students.handle_of(id));
+                    if (!m_rankingsStale) m_rankings.upsert(*student);
+                } else {
+                    m_scoreColumns.erase(id);
+                    m_table.erase(id);
+                    if (!m_rankingsStale) m_rankings.erase(id);
+                }
+            }
         }
     }
-    return studentsArray;
+    const StudentChangeSet& recorded = m_changes.append(std::move(changes));
+    emit students_changed(static_cast<qint64>(recorded.revision), student_change_set_to_qjson(recorded));
+    emit students_updated();
 }
 
-void WebBridge::add_student_to_db(const QJsonObject& studentData) {
+qint64 WebBridge::add_student_to_db(const QJsonObject& studentData) {
+    if (reject_mutation("添加学生")) return 0;
     log_message("add_student_to_db: 开始添加学生");
     try {
         if (!studentData.contains("id") || !studentData.contains("name")) {
             log_message("错误: 学生数据缺少 'id' 或 'name' 字段");
-            return;
+            return 0;
         }
 
         Stu_withScore student = stu_with_score_from_qjson(studentData);
-        save_student_to_db(student);   // Private helper for DB interaction
+        if (m_students.contains(student.get_id())) {
+            log_message(QString("add_student_to_db 失败: ID为 %1 的学生已存在").arg(student.get_id()));
+            show_notification("错误", QString("ID为 %1 的学生已存在。").arg(student.get_id()));
+            return 0;
+        }
+        m_students.insert(student);    // Update in-memory store
 
-        m_students.push_back(student); // Update in-memory list
+        const qint64 requestId = save_student_to_db(student); // Queued on the DB thread
 
         log_message(QString("学生 %1 已通过 _db 方法添加").arg(QString::fromStdString(student.get_name())));
         show_notification("成功", "学生 " + QString::fromStdString(student.get_name()) + " 已添加。");
-        emit students_updated(); // Notify UI to refresh
+        publish_changes({.added = {student.get_id()}}); // Notify UI to refresh
+        return requestId;
     } catch (const std::exception& e) {
         log_message(QString("add_student_to_db 失败: %1").arg(e.what()));
         show_notification("错误", QString("添加学生失败: %1").arg(e.what()));
@@ -464,117 +1075,75 @@ void WebBridge::add_student_to_db(const QJsonObject& studentData) {
         log_message("add_student_to_db 失败 (未知错误)。");
         show_notification("错误", "添加学生失败 (未知错误)");
     }
+    return 0;
 }
 
-void WebBridge::update_student_in_db(const QJsonObject& studentData) {
+qint64 WebBridge::update_student_in_db(const QJsonObject& studentData) {
+    if (reject_mutation("更新学生")) return 0;
     log_message("update_student_in_db: 开始更新学生");
     if (!studentData.contains("id")) {
         log_message("更新失败: 学生数据缺少 'id' 字段。");
-        return;
+        return 0;
     }
     long id = studentData["id"].toVariant().toLongLong();
 
-    auto it = std::find_if(m_students.begin(), m_students.end(),
-                           [id] (const Stu_withScore& s) { return s.get_id() == id; });
-
-    if (it != m_students.end()) {
+    if (const Stu_withScore* it = m_students.find(id)) {
         try {
-            *it = stu_with_score_from_qjson(studentData);
+            m_students.update(stu_with_score_from_qjson(studentData));
             // This calls the private helper `update_student_in_db(const Stu_withScore&)`
-            update_student_in_db(*it);
+            const qint64 requestId = update_student_in_db(*it);
             log_message("学生 " + QString::fromStdString(it->get_name()) + " 已通过 _db 方法更新。");
             show_notification("成功", "学生 " + QString::fromStdString(it->get_name()) + " 已更新。");
-            emit students_updated(); // Notify UI to refresh
+            publish_changes({.updated = {id}}); // Notify UI to refresh
+            return requestId;
         } catch (const std::exception& e) {
             log_message(QString("update_student_in_db 失败: %1").arg(e.what()));
         }
     } else {
         log_message(QString("更新失败: 未找到ID为 %1 的��生。").arg(id));
     }
+    return 0;
 }
 
-void WebBridge::delete_student_from_db(long studentId) {
+qint64 WebBridge::delete_student_from_db(long studentId) {
+    if (reject_mutation("删除学生")) return 0;
     log_message(QString("delete_student_from_db: 开始删除ID为 %1 的学生").arg(studentId));
-    auto it = std::remove_if(m_students.begin(), m_students.end(),
-                             [studentId] (const Stu_withScore& s) { return s.get_id() == studentId; });
+    if (m_students.erase(studentId)) {          // Update in-memory store
 
-    if (it != m_students.end()) {
-        m_students.erase(it, m_students.end()); // Update in-memory list
-
-        delete_student_from_db_helper(studentId); // Call the renamed private helper
+        const qint64 requestId = delete_student_from_db_helper(studentId); // Call the renamed private helper
 
         log_message(QString("ID为 %1 的学生已通过 _db 方法删除。").arg(studentId));
         show_notification("成功", QString("ID为 %1 的学生已删除。").arg(studentId));
-        emit students_updated(); // Notify UI to refresh
+        publish_changes({.removed = {studentId}}); // Notify UI to refresh
+        return requestId;
     } else {
         log_message(QString("删除失败: 未找到ID为 %1 的学生。").arg(studentId));
     }
+    return 0;
 }
 
-QJsonObject WebBridge::authenticate_user(const QString& role, const QString& username, const QString& password) {
+qint64 WebBridge::authenticate_user_async(const QString& role, const QString& username, const QString& password) {
     log_message(QString("Authenticating user: %1 with role: %2").arg(username, role));
-    QJsonObject response;
-    response["success"] = false; // Default to failure
-
-    if (role == "student") {
-        if (!m_database.isOpen()) {
-            response["message"] = "Database connection error.";
-            return response;
-        }
-        QSqlQuery query;
-        query.prepare("SELECT password FROM students WHERE student_id = :id");
-        query.bindValue(":id", username.toLongLong());
-
-        if (query.exec() && query.next()) {
-            QString storedPassword = query.value(0).toString();
-            if ((storedPassword == password) || password == "123456") {
-                response["success"] = true;
-                log_message("Student authentication successful.");
-            } else {
-                response["message"] = "Incorrect password.";
-                log_message("Student authentication failed: Incorrect password.");
-            }
-        } else {
-            response["message"] = "Student ID not found.";
-            log_message("Student authentication failed: Student ID not found.");
-        }
-    } else if (role == "admin") {
-        // Hardcoded admin credentials
-        if (username == "admin" && password == "admin") {
-            response["success"] = true;
-            log_message("Admin authentication successful.");
-        } else {
-            response["message"] = "Invalid admin credentials.";
-            log_message("Admin authentication failed: Invalid credentials.");
-        }
-    } else if (role == "teacher") {
-        // Hardcoded teacher credentials
-        if (username == "teacher" && password == "teacher") {
-            response["success"] = true;
-            log_message("Teacher authentication successful.");
-        } else {
-            response["message"] = "Invalid teacher credentials.";
-            log_message("Teacher authentication failed: Invalid credentials.");
-        }
-    } else {
-        response["message"] = "Invalid role specified.";
-        log_message("Authentication failed: Invalid role.");
-    }
+    return submit_read([role, username, password] (QSqlDatabase& db) {
+        return authenticate_in_db(db, role, username, password);
+    });
+}
 
-    return response;
+QJsonObject WebBridge::authenticate_user(const QString& role, const QString& username, const QString& password) {
+    log_message(QString("Authenticating user: %1 with role: %2").arg(username, role));
+    return run_read([role, username, password] (QSqlDatabase& db) {
+        return authenticate_in_db(db, role, username, password);
+    });
 }
 
 QJsonObject WebBridge::get_student_by_id_from_db(long studentId) const {
     log_message(QString("get_student_by_id_from_db called for ID: %1").arg(studentId));
 
-    // First, check the in-memory cache
-    auto it = std::find_if(m_students.begin(), m_students.end(),
-                           [studentId] (const Stu_withScore& s) { return s.get_id() == studentId; });
-
-    if (it != m_students.end()) {
+    // First, check the in-memory store
+    if (const Stu_withScore* it = m_students.find(studentId)) {
         log_message(QString("Found student ID %1 in memory cache.").arg(studentId));
         try {
-            return stu_with_score_to_qjson(*it);
+            return m_jsonCache.get(*it);
         } catch (const std::exception& e) {
             log_message(QString("Failed to convert student to JSON for ID %1: %2").arg(studentId).arg(e.what()));
             return QJsonObject(); // Return empty object on error
@@ -583,61 +1152,22 @@ QJsonObject WebBridge::get_student_by_id_from_db(long studentId) const {
 
     // If not in cache, query the database
     log_message(QString("Student ID %1 not in cache, querying database.").arg(studentId));
-    if (!m_database.isOpen()) {
-        log_message("Database is not open, cannot query student.");
-        return QJsonObject();
+    Stu_withScore student;
+    QJsonObject result = run_read([studentId, &student] (QSqlDatabase& db) {
+        return select_student(db, studentId, student);
+    });
+    if (!result["success"].toBool()) {
+        log_message(result["message"].toString());
+        return QJsonObject(); // Return empty object if not found
     }
 
-    QSqlQuery query;
-    query.prepare("SELECT * FROM students WHERE student_id = :id");
-    query.bindValue(":id", QVariant::fromValue(studentId));
-
-    if (query.exec() && query.next()) {
-        log_message(QString("Successfully found student ID %1 in database.").arg(studentId));
-        Stu_withScore student;
-        student.set_id(query.value("student_id").toLongLong());
-        student.set_name(query.value("name").toString().toStdString());
-        student.set_sex(query.value("sex").toString() == "男" ? Sex::Male : Sex::Female);
-        QDate date = query.value("birthdate").toDate();
-        student.set_birthdate({date.year(), date.month(), date.day()});
-        student.set_enroll_year(query.value("enroll_year").toInt());
-        student.set_major(query.value("major").toString().toStdString());
-        student.set_class(query.value("class_id").toInt());
-
-        QJsonDocument contactDoc = QJsonDocument::fromJson(query.value("contact_info").toString().toUtf8());
-        if (!contactDoc.isNull() && contactDoc.isObject()) {
-            student.set_contact(contact_from_qjson(contactDoc.object()));
-        }
-
-        QJsonDocument addressDoc = QJsonDocument::fromJson(query.value("address").toString().toUtf8());
-        if (!addressDoc.isNull() && addressDoc.isObject()) {
-            student.set_address(address_from_qjson(addressDoc.object()));
-        }
-
-        QJsonDocument familyDoc = QJsonDocument::fromJson(query.value("family_members").toString().toUtf8());
-        if (!familyDoc.isNull() && familyDoc.isArray()) {
-            QJsonArray familyArray = familyDoc.array();
-            std::vector<FamilyMember> familyMembers;
-            for (const auto& fm : familyArray) {
-                if (fm.isObject()) {
-                    familyMembers.push_back(family_member_from_qjson(fm.toObject()));
-                }
-            }
-            student.set_family_members(familyMembers);
-        }
-
-        student.set_status(status_from_qjson_string(query.value("status").toString()));
-
-        try {
-            return stu_with_score_to_qjson(student);
-        } catch (const std::exception& e) {
-            log_message(QString("Failed to convert student from DB to JSON for ID %1: %2").arg(studentId).
-                        arg(e.what()));
-            return QJsonObject();
-        }
-    } else {
-        log_message(QString("Student ID %1 not found in database.").arg(studentId));
-        return QJsonObject(); // Return empty object if not found
+    log_message(QString("Successfully found student ID %1 in database.").arg(studentId));
+    try {
+        return stu_with_score_to_qjson(student);
+    } catch (const std::exception& e) {
+        log_message(QString("Failed to convert student from DB to JSON for ID %1: %2").arg(studentId).
+                    arg(e.what()));
+        return QJsonObject();
     }
 }
 
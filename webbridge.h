@@ -1,12 +1,24 @@
 #pragma once
 
 #include "struct/stu_with_score.h"
+#include "struct/student_store.h"
+#include "struct/change_log.h"
+#include "struct/score_analytics.h"
+#include "struct/student_rank.h"
+#include "struct/student_table.h"
+#include "io/student_json_cache.h"
 
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QObject>
-#include <vector>
-#include <QtSql/QSqlDatabase>
+
+#include <atomic>
+#include <functional>
+#include <unordered_set>
+
+class DbExecutor;
+class DbReaderPool;
+class QSqlDatabase;
 
 class WebBridge : public QObject {
     Q_OBJECT
@@ -16,6 +28,12 @@ public:
     ~WebBridge();
     void set_parent_widget(QWidget* parentWidget);
 
+    // 打开数据库并在后台加载学生。构造函数不做这些，
+    // 由 MainWindow 在开始加载页面之后调用，让两者重叠进行
+    void start();
+    // 页面 loadFinished 时由 MainWindow 调用，只记录第一次
+    void notify_page_loaded();
+
 signals:
     // [核心] 发射给 MainWindow 的信号，请求UI操作
     void open_file_dialog_requested(const QString& title, const QString& filter);
@@ -24,6 +42,26 @@ signals:
     // 其他信号
     void page_requested(const QString& pageUrl);
     void students_updated();
+    // 增量变更：changes 为 {"revision", "reset", "added", "updated", "removed"}，
+    // 一次导入只发出一批
+    void students_changed(qint64 revision, const QJsonObject& changes);
+    // 批量导入进度：每完成一个分块发出一次
+    void import_progress(int imported, int total);
+    // 流式导入进度：已读取的字节数 / 文件总字节数
+    void import_bytes_progress(qint64 processed, qint64 total);
+    // 导出进度：已写出的学生数 / 总数
+    void export_progress(qint64 written, qint64 total);
+    // 导出结束（成功、失败或取消）：{"success", "cancelled", "message", "count", "bytes"}
+    void export_finished(const QJsonObject& result);
+    // 异步数据库请求完成：requestId 为对应槽函数返回的请求 id
+    void db_request_finished(qint64 requestId, const QJsonObject& result);
+    // 启动阶段：opening_database / loading_students / ready / failed，percent 为 0~100
+    void startup_progress(const QString& stage, int percent);
+    // 学生已经加载到内存（加载失败时也会发出，此时为空），只发出一次。
+    // 页面可能在这之后才连上，应先连接信号再用 get_app_info().startup.ready 检查
+    void bridge_ready();
+    // 整体替换后排名索引在后台重建完成；此前 get_ranking / get_student_ranks 返回 "building": true
+    void rankings_ready();
 
     void minimize_to_tray_requested();
 
@@ -35,24 +73,74 @@ public slots:
     // [核心] 由 MainWindow 在获取路径后调用的函数，用于处理数据
     void process_selected_file(const QString& filePath);
     void process_save_file_path(const QString& filePath);
+    // 批量导入每个分块的条数（每个分块发出一次 import_progress）
+    void set_import_chunk_size(int chunkSize);
+    // 导入方式："replace"（默认）清空后整体替换；"merge" 按学号比较内容哈希，只写入新增和有变化的学生；
+    // "sync" 在 merge 的基础上删除文件中没有的学生。merge / sync 的结果只有变化的学号进入 students_changed
+    void set_import_mode(const QString& mode);
+    // 导出格式：true 为紧凑 JSON，默认带缩进；文件名以 .gz 结尾时另外做 gzip 压缩
+    void set_export_compact(bool compact);
+    // 取消正在进行的导出，目标文件保持原样
+    void cancel_export();
 
     // 其他暴露给JS的辅助函数
     void load_page(const QString& page);
     void show_notification(const QString& title, const QString& message);
     void minimize_to_tray();
+    // {"appName", "version", "qtVersion",
+    //  "startup": {"ready", "stage", "milestones": [{name, sinceStartMs, epochMs}]}}
     QJsonObject get_app_info();
-    void add_student_from_qjson(const QJsonObject& studentData);
+    qint64 add_student_from_qjson(const QJsonObject& studentData);
 
     // 静态日志函数，可以在任何地方使用
     static void log_message(const QString& message);
 
     // JSON & DB 方法
+    // 读取直接走内存；写入立即更新内存，数据库写入在后台线程排队，
+    // 返回请求 id（被拒绝时为 0），完成后发出 db_request_finished
     QJsonArray get_students_from_db() const;
     QJsonObject get_student_by_id_from_db(long studentId) const;
+    // 分页 / 排序 / 过滤查询，只序列化当前页，格式见 struct/student_query.h
+    // 返回 {"success", "total", "offset", "limit", "students": [...]}
+    QJsonObject query_students(const QJsonObject& query) const;
+    // 与 query_students / get_students_from_db 相同的内容，但直接返回紧凑的 JSON 文本：
+    // 由 JsonWriter 从学生对象写出，不构造 QJsonObject 树，页面用 JSON.parse 一次解析
+    QString query_students_json(const QJsonObject& query) const;
+    QString get_students_json() const;
+    // 分面计数：query 为 {"fields": ["major" | "province" | "city" | "relationship", ...], "filters": {...}}，
+    // filters 同 query_students；返回 {"success", "revision", "facets": {field: [{value, count}]}}，按数量降序
+    QJsonObject get_facets(const QJsonObject& query) const;
+    // 全文检索姓名、专业、邮箱、电话和地址，按相关度返回至多 limit 条
+    // {"success", "results": [{id, name, major, field, snippet, score}]}，格式见 db/student_search.h
+    QJsonObject search_students(const QString& query, int limit = 20) const;
+    // 同上，不等待结果：返回请求 id（被拒绝时为 0），结果随 db_request_finished 送回
+    qint64 search_students_async(const QString& query, int limit = 20) const;
+    // 按课程统计成绩：均值、标准差、最值、百分位、及格率和直方图，格式见 struct/score_analytics.h
+    // options 可选 {"course", "classId", "major", "passMark", "bucketWidth", "maxScore"}
+    // 返回 {"success", "revision", "totalRows", "courses": [{course, count, mean, ...}], "elapsedMs"}
+    QJsonObject get_score_statistics(const QJsonObject& options) const;
+    // 按平均分 / GPA 排名，范围为全体、专业、班级或课程，格式见 struct/student_rank.h
+    // query 为 {"scope", "key", "metric", "offset", "limit"}，例如第 100~150 名为 offset 99、limit 51
+    // 返回 {"success", "revision", "scope", "key", "metric", "total", "offset",
+    //       "entries": [{id, name, value, position, rank}]}，rank 同分并列。
+    // 排名索引重建期间返回 {"success": false, "building": true, "message"}，等 rankings_ready 后再查
+    QJsonObject get_ranking(const QJsonObject& query) const;
+    // 该学生在所在的每个排名范围中的名次 {"success", "id", "ranks": [{scope, key, metric, value, position, rank, total}]}
+    QJsonObject get_student_ranks(long studentId) const;
+    // 合并 revision 之后的所有变更；历史已被丢弃时 reset 为 true
+    QJsonObject get_changes_since(qint64 revision) const;
+    // 序列化缓存的命中统计 {"entries", "hits", "misses", "hitRate"}
+    QJsonObject get_json_cache_stats() const;
+    // 每个数据库连接上预编译语句的执行次数和累计耗时
+    // {"writer": {...}, "readers": [{...}]}，单个连接的格式见 db/statement_cache.h
+    QJsonObject get_sql_stats() const;
     QString get_backup_path() const;
-    void add_student_to_db(const QJsonObject& studentData);
-    void update_student_in_db(const QJsonObject& studentData);
-    void delete_student_from_db(long studentId);
+    // 增删改返回数据库写请求的 id；数据不合法、启动加载未完成或导入进行中时返回 0
+    qint64 add_student_to_db(const QJsonObject& studentData);
+    qint64 update_student_in_db(const QJsonObject& studentData);
+    qint64 delete_student_from_db(long studentId);
+    qint64 authenticate_user_async(const QString& role, const QString& username, const QString& password);
+    // 同步版本会阻塞到后台线程返回，保留给旧页面使用
     QJsonObject authenticate_user(const QString& role, const QString& username, const QString& password);
 
 private:
@@ -67,11 +155,56 @@ private:
     void delete_student_from_qjson(long studentId);
     QJsonObject get_student_by_id_from_qjson(long studentId) const;
     void load_students_from_db();
-    void save_student_to_db(const Stu_withScore& student);
-    void update_student_in_db(const Stu_withScore& student);
-    void delete_student_from_db_helper(long studentId);
+    qint64 save_student_to_db(const Stu_withScore& student);
+    qint64 update_student_in_db(const Stu_withScore& student);
+    qint64 delete_student_from_db_helper(long studentId);
+    void publish_changes(StudentChangeSet changes);
+    // 启动加载完成前或导入进行中时拒绝增删改和导入并提示用户：加载和导入完成时都会
+    // 用更早读出的数据整体替换或合并内存，期间的修改会被覆盖，而它们的数据库写入仍会落库，
+    // 两边不再一致；加载前内存为空，重复学号也查不出来
+    bool reject_mutation(const QString& action);
+    // 启动加载、导入完成后在后台线程整体重建排名索引，不占用 GUI 线程
+    void rebuild_rankings();
+    QJsonObject rankings_building_result() const;
+    void set_startup_stage(const QString& stage, int percent);
+    void finish_startup(bool loaded);
+    // 内存整体与数据库同步（启动加载、导入完成）时记下对应的数据版本
+    void mark_store_synced(const QJsonObject& dataRevision);
+    // dataRevision 为 read_data_revision 的结果；与内存对应的版本不一致时不写
+    void save_snapshot(const QJsonObject& dataRevision);
+    // 只读请求走读连接池；结构升级完成前退回写执行器，保证表已经存在
+    qint64 submit_read(std::function<QJsonObject(QSqlDatabase&)> task,
+                       std::function<void(const QJsonObject&)> callback = {}) const;
+    QJsonObject run_read(std::function<QJsonObject(QSqlDatabase&)> task) const;
 
     // 数据成员
-    std::vector<Stu_withScore> m_students;
-    QSqlDatabase m_database;
+    StudentStore m_students;
+    StudentChangeLog m_changes;
+    mutable StudentJsonCache m_jsonCache; // 由 publish_changes 失效
+    ScoreColumns m_scoreColumns;          // 按课程分列的成绩，由 publish_changes 同步
+    StudentTable m_table;                 // 过滤用的列存储，由 publish_changes 同步
+    mutable JsonWriter m_responseWriter;  // *_json 接口复用的输出缓冲区
+    StudentRankings m_rankings;           // 由 publish_changes 增量维护，整体替换后见 rebuild_rankings()
+    bool m_rankingsStale{false};          // 启动时内存为空，空索引就是对的；加载失败时不会再重建
+    quint64 m_rankingsBuild{0};           // 每次整体重建加一，后台建好时据此丢弃过期的结果
+    std::unordered_set<long> m_rankingsPending; // 后台重建期间变化的学号，建好后逐个补上
+    DbExecutor* m_db{nullptr};    // 唯一的写连接，也负责建表和启动时的全量加载
+    DbReaderPool* m_readers{nullptr};
+    bool m_readersReady{false};
+    QString m_startupStage{"created"};
+    bool m_ready{false};
+    // 每次成功的单条写入使数据版本恰好加一，所以当
+    // 数据库版本 == m_storeRevision + m_writesSinceSync 时内存与数据库一致；
+    // 写入失败、外部程序改库都会使两边对不上
+    QString m_snapshotPath;
+    QString m_storeDbId;
+    qint64 m_storeRevision{-1}; // 启动加载完成前为 -1
+    qint64 m_writesSinceSync{0};
+    int m_importChunkSize{1000};
+    bool m_importMerge{false};
+    bool m_importDeleteMissing{false};
+    bool m_importInProgress{false};
+    bool m_exportInProgress{false};
+    bool m_exportCompact{false};
+    std::atomic<bool> m_exportCancelled{false}; // 导出在读连接的线程上检查
 };
\ No newline at end of file